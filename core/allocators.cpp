@@ -1,8 +1,16 @@
 #include "allocators.h"
 
+#include <new>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include "util/ptr_util.h"
 #include "oak_assert.h"
 #include "log.h"
+#include "memory_tracker.h"
 
 namespace oak {
 
@@ -20,10 +28,10 @@ namespace oak {
 			log_print_warn("memory leak, remaining blocks: %u", numAllocs_);
 		}
 
-		detail::Block *p = memList_;
-		detail::Block *next = nullptr;
+		Header *p = memList_;
+		Header *next = nullptr;
 		while (p != nullptr) {
-			next = static_cast<detail::Block*>(p->next);
+			next = p->next;
 			free(p);
 			p = next;
 			numAllocs_ --;
@@ -32,44 +40,47 @@ namespace oak {
 	}
 
 	namespace debug::vars {
-		extern size_t allocatedMemory;
+		extern std::atomic<size_t> allocatedMemory;
 	}
 	void* ProxyAllocator::allocate(size_t size) {
-		void *ptr = aligned_alloc(64, size + sizeof(detail::Block));
-		detail::Block *l = static_cast<detail::Block*>(ptr);
-		l->next = memList_;
-		l->size = size;
-		memList_ = l;
+		//aligned_alloc requires the size to be a multiple of the alignment
+		const size_t total = ptrutil::alignSize(size + sizeof(Header), alignof(Header));
+		Header *header = static_cast<Header*>(aligned_alloc(alignof(Header), total));
+		oak_assert(header != nullptr);
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		header->prev = nullptr;
+		header->next = memList_;
+		header->size = size;
+		if (memList_ != nullptr) {
+			memList_->prev = header;
+		}
+		memList_ = header;
 
 		numAllocs_ ++;
 
-		debug::vars::allocatedMemory += size + sizeof(detail::Block);
+		debug::vars::allocatedMemory.fetch_add(size + sizeof(Header), std::memory_order_relaxed);
 
-		return ptrutil::add(ptr, sizeof(detail::Block));
+		return header + 1;
 	}
 
 	void ProxyAllocator::deallocate(void *ptr, size_t size) {
-		//search through linked list for ptr - sizeof(memList) then remove from list and deallocate
-		ptr = ptrutil::subtract(ptr, sizeof(detail::Block));
+		Header *header = static_cast<Header*>(ptr) - 1;
+		std::unique_lock<std::mutex> lock{ mutex_ };
 
-		debug::vars::allocatedMemory -= size + sizeof(detail::Block);
-		
-		detail::Block *p = memList_;
-		detail::Block *prev = nullptr;
-		while (p != nullptr) {
-			if (p == ptr) {
-				if (prev != nullptr) {
-					prev->next = p->next;
-				} else {
-					memList_ = static_cast<detail::Block*>(p->next);
-				}
-				numAllocs_--;
-				free(p);
-				break;
-			}
-			prev = p;
-			p = static_cast<detail::Block*>(p->next);
+		debug::vars::allocatedMemory.fetch_sub(size + sizeof(Header), std::memory_order_relaxed);
+
+		//unlink the block
+		if (header->prev != nullptr) {
+			header->prev->next = header->next;
+		} else {
+			memList_ = header->next;
 		}
+		if (header->next != nullptr) {
+			header->next->prev = header->prev;
+		}
+		numAllocs_--;
+		lock.unlock();
+		free(header);
 	}
 
 	LinearAllocator::LinearAllocator(Allocator *parent, size_t pageSize, uint32_t alignment) : Allocator{ parent, alignment }, pageSize_{ pageSize } {
@@ -133,6 +144,128 @@ namespace oak {
 		nHeader->size = pageSize_ + sizeof(detail::Block);
 	}
 
+	VirtualArena::VirtualArena(size_t reserveSize, size_t commitSize, size_t trimSize, uint32_t alignment, MemoryTag tag) : 
+	Allocator{ nullptr, alignment }, committed_{ 0 }, used_{ 0 }, trimSize_{ trimSize }, tag_{ tag } {
+		//commits are whole pages
+		const size_t osPage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		commitSize_ = ptrutil::alignSize(commitSize, osPage);
+		reserved_ = ptrutil::alignSize(reserveSize, commitSize_);
+		oak_assert(alignment_ <= osPage);
+		//the range is reserved without backing, touching it faults until it is committed
+		start_ = mmap(nullptr, reserved_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		oak_assert(start_ != MAP_FAILED);
+	}
+
+	VirtualArena::~VirtualArena() {
+		debug::vars::allocatedMemory.fetch_sub(committed_, std::memory_order_relaxed);
+		if (committed_ > 0) {
+			memory::trackFree(tag_, committed_);
+		}
+		munmap(start_, reserved_);
+	}
+
+	void* VirtualArena::allocate(size_t size) {
+		const size_t offset = ptrutil::alignSize(used_, alignment_);
+		const size_t end = offset + size;
+		if (end > committed_) {
+			oak_assert(end <= reserved_);
+			const size_t commit = ptrutil::alignSize(end, commitSize_);
+			int result = mprotect(ptrutil::add(start_, committed_), commit - committed_, PROT_READ | PROT_WRITE);
+			oak_assert(result == 0);
+			debug::vars::allocatedMemory.fetch_add(commit - committed_, std::memory_order_relaxed);
+			memory::trackAlloc(tag_, commit - committed_);
+			committed_ = commit;
+		}
+		used_ = end;
+		return ptrutil::add(start_, offset);
+	}
+
+	void VirtualArena::deallocate(void *ptr, size_t size) {}
+
+	void VirtualArena::clear() {
+		//after a spike most of the committed pages would sit unused, hand them back
+		if (trimSize_ != 0 && committed_ > trimSize_ && committed_ > used_ * 4) {
+			trim(used_);
+		}
+		used_ = 0;
+	}
+
+	void VirtualArena::trim(size_t keep) {
+		keep = ptrutil::alignSize(keep < used_ ? used_ : keep, commitSize_);
+		if (keep >= committed_) { return; }
+		void *ptr = ptrutil::add(start_, keep);
+		const size_t size = committed_ - keep;
+		//dropping the pages frees the physical memory, protecting them again uncommits them
+		madvise(ptr, size, MADV_DONTNEED);
+		mprotect(ptr, size, PROT_NONE);
+		debug::vars::allocatedMemory.fetch_sub(size, std::memory_order_relaxed);
+		memory::trackFree(tag_, size);
+		committed_ = keep;
+	}
+
+	StackAllocator::StackAllocator(size_t reserveSize, uint32_t alignment) : VirtualArena{ reserveSize, 64_kb, 4_mb, alignment } {}
+
+	void StackAllocator::deallocate(void *ptr, size_t size) {
+		//the top may have been padded for alignment after an earlier pop
+		const size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - static_cast<char*>(start_));
+		if (ptrutil::alignSize(offset + size, alignment_) == ptrutil::alignSize(used_, alignment_)) {
+			used_ = offset;
+		}
+	}
+
+	void StackAllocator::rollback(size_t marker) {
+		oak_assert(marker <= used_);
+		if (marker == 0) {
+			//the stack is empty, a good time to release the pages of a spike
+			clear();
+		}
+		used_ = marker;
+	}
+
+	FrameAllocator::PageSource::PageSource(Allocator *parent) : Allocator{ parent, parent->getAlignment() } {}
+
+	void* FrameAllocator::PageSource::allocate(size_t size) {
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		return parent_->allocate(size);
+	}
+
+	void FrameAllocator::PageSource::deallocate(void *ptr, size_t size) {
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		parent_->deallocate(ptr, size);
+	}
+
+	FrameAllocator::FrameAllocator(Allocator *parent, size_t reserveSize, uint32_t alignment, MemoryTag tag) : 
+	Allocator{ parent, alignment }, reserveSize_{ reserveSize }, tag_{ tag }, pages_{ parent }, arenas_{} {}
+
+	FrameAllocator::~FrameAllocator() {
+		for (auto arena : arenas_) {
+			if (arena != nullptr) {
+				arena->~VirtualArena();
+				pages_.deallocate(arena, sizeof(VirtualArena));
+			}
+		}
+	}
+
+	void* FrameAllocator::allocate(size_t size) {
+		//only the thread that owns the slot touches its arena until the next clear
+		auto& arena = arenas_[util::threadSlot()];
+		if (arena == nullptr) {
+			arena = static_cast<VirtualArena*>(pages_.allocate(sizeof(VirtualArena)));
+			new (arena) VirtualArena{ reserveSize_, 64_kb, 4_mb, alignment_, tag_ };
+		}
+		return arena->allocate(size);
+	}
+
+	void FrameAllocator::deallocate(void *ptr, size_t size) {}
+
+	void FrameAllocator::clear() {
+		for (auto arena : arenas_) {
+			if (arena != nullptr) {
+				arena->clear();
+			}
+		}
+	}
+
 	FreelistAllocator::FreelistAllocator(Allocator *parent, size_t pageSize, uint32_t alignment) : 
 	Allocator{ parent, alignment }, pageSize_{ pageSize } {
 		oak_assert(pageSize_ > sizeof(detail::Block));
@@ -160,6 +293,7 @@ namespace oak {
 
 	void* FreelistAllocator::allocate(size_t size) {
 		oak_assert(size != 0 && size <= pageSize_);
+		std::lock_guard<std::mutex> lock{ mutex_ };
 		detail::Block *prev = nullptr;
 		detail::Block *p = freeList_;
 
@@ -219,6 +353,7 @@ namespace oak {
 
 	void FreelistAllocator::deallocate(void *ptr, size_t size) {
 		oak_assert(ptr != nullptr);
+		std::lock_guard<std::mutex> lock{ mutex_ };
 
 		AllocationHeader* header = static_cast<AllocationHeader*>(ptrutil::subtract(ptr, sizeof(AllocationHeader)));
 
@@ -290,97 +425,367 @@ namespace oak {
 		lastNode->next = newBlock;
 	}
 
-	PoolAllocator::PoolAllocator(Allocator *parent, size_t pageSize, size_t objectSize, uint32_t alignment) : 
-	Allocator{ parent, alignment }, pageSize_{ pageSize }, objectSize_{ ptrutil::alignSize(objectSize, alignment_) } {
-		start_ = parent_->allocate(pageSize_ + sizeof(detail::Block));
-		detail::Block *header = static_cast<detail::Block*>(start_);
-		header->next = nullptr;
-		header->size = pageSize_ + sizeof(detail::Block);
+	PoolAllocator::PoolAllocator(Allocator *parent, size_t pageSize, size_t objectSize, uint32_t alignment, MemoryTag tag) : 
+	Allocator{ parent, alignment }, 
+	pageSize_{ pageSize }, 
+	objectSize_{ ptrutil::alignSize(objectSize < sizeof(void*) ? sizeof(void*) : objectSize, alignment_) },
+	headerSize_{ ptrutil::alignSize(sizeof(PageHeader), alignment_) },
+	objectCount_{ 0 }, tag_{ tag },
+	partial_{ nullptr }, empty_{ nullptr },
+	pages_{ nullptr }, pageCount_{ 0 }, pagesCapacity_{ 0 } {
+		const size_t osPage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		oak_assert(alignment_ <= osPage);
+		pageBytes_ = ptrutil::alignSize(headerSize_ + pageSize_, osPage);
+		//the rounding slack holds more slots
+		pageCapacity_ = static_cast<uint32_t>((pageBytes_ - headerSize_) / objectSize_);
+		oak_assert(pageCapacity_ > 0);
+	}
 
-		size_t count = (pageSize_ & ~(alignment_-1)) / objectSize_;
+	PoolAllocator::~PoolAllocator() {
+		for (size_t i = 0; i < pageCount_; i++) {
+			unmapPage(pages_[i]);
+		}
+		if (pages_ != nullptr) {
+			parent_->deallocate(pages_, pagesCapacity_ * sizeof(PageHeader*));
+		}
+	}
 
-		freeList_ = static_cast<void**>(ptrutil::add(start_, sizeof(detail::Block)));
+	void* PoolAllocator::allocate(size_t size) {
+		PageHeader *page = partial_;
+		if (page == nullptr) {
+			if (empty_ != nullptr) {
+				page = empty_;
+				empty_ = nullptr;
+			} else {
+				page = addPage();
+			}
+			link(page);
+		}
 
-		void **p = freeList_;
+		void *ptr;
+		if (page->freeList != nullptr) {
+			ptr = page->freeList;
+			page->freeList = *static_cast<void**>(ptr);
+		} else {
+			ptr = ptrutil::add(page, headerSize_ + page->bump * objectSize_);
+			page->bump++;
+		}
 
-		for (size_t i = 0; i < count - 1; i++) {
-			*p = ptrutil::add(p, objectSize_);
-			p = static_cast<void**>(*p);
+		if (++page->used == pageCapacity_) {
+			unlink(page);
 		}
+		objectCount_++;
+		return ptr;
+	}
+
+	void PoolAllocator::deallocate(void *ptr, size_t size) {
+		PageHeader *page = findPage(ptr);
+		oak_assert(page != nullptr && page->used > 0);
 
-		*p = nullptr;
+		*static_cast<void**>(ptr) = page->freeList;
+		page->freeList = ptr;
+		objectCount_--;
 
+		if (page->used-- == pageCapacity_) {
+			//the page was full so it isnt in the partial list
+			link(page);
+		}
+		if (page->used == 0) {
+			unlink(page);
+			if (empty_ != nullptr) {
+				removePage(empty_);
+			}
+			empty_ = page;
+		}
 	}
 
-	PoolAllocator::~PoolAllocator() {
-		//deallocate used memory
-		detail::Block *prev = nullptr;
-		detail::Block *p = static_cast<detail::Block*>(start_);
-		while (p) {
-			prev = p;
-			p = static_cast<detail::Block*>(p->next);
+	void PoolAllocator::trim() {
+		if (empty_ != nullptr) {
+			removePage(empty_);
+			empty_ = nullptr;
+		}
+	}
 
-			parent_->deallocate(prev, prev->size);
+	float PoolAllocator::getFragmentation() const {
+		if (pageCount_ == 0) { return 0.0f; }
+		return 1.0f - static_cast<float>(objectCount_) / static_cast<float>(pageCount_ * pageCapacity_);
+	}
+
+	size_t PoolAllocator::pagesBefore(const void *ptr) const {
+		//number of pages that start at or before ptr
+		size_t lo = 0, hi = pageCount_;
+		while (lo < hi) {
+			size_t mid = (lo + hi) / 2;
+			if (static_cast<const void*>(pages_[mid]) <= ptr) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
 		}
+		return lo;
 	}
 
-	void* PoolAllocator::allocate(size_t size) {
-		if (*freeList_ == nullptr) {
-			grow();
+	PoolAllocator::PageHeader* PoolAllocator::findPage(void *ptr) const {
+		size_t i = pagesBefore(ptr);
+		if (i == 0) { return nullptr; }
+		PageHeader *page = pages_[i - 1];
+		return ptr < ptrutil::add(page, pageBytes_) ? page : nullptr;
+	}
+
+	PoolAllocator::PageHeader* PoolAllocator::addPage() {
+		if (pageCount_ == pagesCapacity_) {
+			size_t capacity = pagesCapacity_ == 0 ? 16 : pagesCapacity_ * 2;
+			auto pages = static_cast<PageHeader**>(parent_->allocate(capacity * sizeof(PageHeader*)));
+			if (pages_ != nullptr) {
+				std::memcpy(pages, pages_, pageCount_ * sizeof(PageHeader*));
+				parent_->deallocate(pages_, pagesCapacity_ * sizeof(PageHeader*));
+			}
+			pages_ = pages;
+			pagesCapacity_ = capacity;
 		}
 
-		void *p = freeList_;
-		freeList_ = static_cast<void**>(*freeList_);
+		//pages are mapped directly so unmapping an empty page gives its memory back to the os
+		void *mem = mmap(nullptr, pageBytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		oak_assert(mem != MAP_FAILED);
+		debug::vars::allocatedMemory.fetch_add(pageBytes_, std::memory_order_relaxed);
+		memory::trackAlloc(tag_, pageBytes_);
+
+		auto page = static_cast<PageHeader*>(mem);
+		page->prev = page->next = nullptr;
+		page->freeList = nullptr;
+		page->used = 0;
+		page->bump = 0;
+
+		//keep the page list sorted
+		size_t i = pageCount_;
+		while (i > 0 && pages_[i - 1] > page) {
+			pages_[i] = pages_[i - 1];
+			i--;
+		}
+		pages_[i] = page;
+		pageCount_++;
+		return page;
+	}
 
-		return p;
+	void PoolAllocator::removePage(PageHeader *page) {
+		size_t i = pagesBefore(page) - 1;
+		oak_assert(pages_[i] == page);
+		std::memmove(pages_ + i, pages_ + i + 1, (pageCount_ - i - 1) * sizeof(PageHeader*));
+		pageCount_--;
+		unmapPage(page);
 	}
 
-	void PoolAllocator::deallocate(void *p, size_t size) {
-		*static_cast<void**>(p) = freeList_;
-		freeList_ = static_cast<void**>(p);
+	void PoolAllocator::unmapPage(PageHeader *page) {
+		munmap(page, pageBytes_);
+		debug::vars::allocatedMemory.fetch_sub(pageBytes_, std::memory_order_relaxed);
+		memory::trackFree(tag_, pageBytes_);
 	}
 
-	void PoolAllocator::grow() {
-		//find end of freelist
-		void **prev = nullptr;
-		void **p = freeList_;
+	void PoolAllocator::link(PageHeader *page) {
+		page->prev = nullptr;
+		page->next = partial_;
+		if (partial_ != nullptr) {
+			partial_->prev = page;
+		}
+		partial_ = page;
+	}
 
-		while (p) {
-			prev = p;
-			p = static_cast<void**>(*p);
+	void PoolAllocator::unlink(PageHeader *page) {
+		if (page->prev != nullptr) {
+			page->prev->next = page->next;
+		} else {
+			partial_ = page->next;
+		}
+		if (page->next != nullptr) {
+			page->next->prev = page->prev;
 		}
+		page->prev = page->next = nullptr;
+	}
 
-		//find the end of the used block list
-		detail::Block *prevHeader = nullptr;
-		detail::Block *header = static_cast<detail::Block*>(start_);
+	SizeClassAllocator::SizeClassAllocator(Allocator *parent, size_t pageSize) : 
+	Allocator{ parent, 16 }, pageSize_{ pageSize }, freeLists_{}, pages_{ nullptr }, pageCount_{ 0 }, caches_{} {
+		oak_assert(parent->getAlignment() >= alignof(PageHeader));
+		oak_assert(pageSize_ >= sizeof(PageHeader) + MAX_SMALL_SIZE);
+	}
 
-		while (header) {
-			prevHeader = header;
-			header = static_cast<detail::Block*>(header->next);
+	SizeClassAllocator::~SizeClassAllocator() {
+		PageHeader *p = pages_;
+		while (p != nullptr) {
+			PageHeader *next = p->next;
+			parent_->deallocate(p, pageSize_);
+			p = next;
 		}
+	}
 
-		//after loop prev = end of free list
+	size_t SizeClassAllocator::sizeClass(size_t size) {
+		//16 byte steps up to 256 bytes
+		if (size <= 256) {
+			return size == 0 ? 0 : (size + 15) / 16 - 1;
+		}
+		//then four classes for every power of two
+		size_t shift = 8;
+		while ((size_t{ 1 } << (shift + 1)) < size) {
+			shift++;
+		}
+		return 16 + (shift - 8) * 4 + ((size - 1) >> (shift - 2)) - 4;
+	}
 
-		//create new memory block and append it to the used block list
-		void *ptr = parent_->allocate(pageSize_ + sizeof(detail::Block));
-		oak_assert(ptr != nullptr);
-		prevHeader->next = ptr;
-		header = static_cast<detail::Block*>(ptr);
-		header->next = nullptr;
-		header->size = pageSize_ + sizeof(detail::Block);
+	size_t SizeClassAllocator::classSize(size_t index) {
+		if (index < 16) {
+			return (index + 1) * 16;
+		}
+		const size_t j = index - 16;
+		const size_t shift = 8 + j / 4;
+		return (5 + j % 4) << (shift - 2);
+	}
 
-		size_t count = (pageSize_ & ~(alignment_-1)) / objectSize_;
+	void* SizeClassAllocator::allocate(size_t size) {
+		if (size > MAX_SMALL_SIZE) {
+			return parent_->allocate(size);
+		}
+		const size_t index = sizeClass(size);
+		//only the thread that owns the slot touches its cache
+		auto& cache = caches_[util::threadSlot()];
+		if (cache.freeLists[index] == nullptr) {
+			refill(cache, index);
+		}
+		void *ptr = cache.freeLists[index];
+		cache.freeLists[index] = *static_cast<void**>(ptr);
+		cache.counts[index]--;
+		return ptr;
+	}
 
-		*prev = ptrutil::add(ptr, sizeof(detail::Block));
+	void SizeClassAllocator::deallocate(void *ptr, size_t size) {
+		if (size > MAX_SMALL_SIZE) {
+			parent_->deallocate(ptr, size);
+			return;
+		}
+		const size_t index = sizeClass(size);
+		//slots freed by another thread than the one that allocated them move to the freeing threads cache
+		auto& cache = caches_[util::threadSlot()];
+		*static_cast<void**>(ptr) = cache.freeLists[index];
+		cache.freeLists[index] = ptr;
+		if (++cache.counts[index] > 2 * batchSize(index)) {
+			release(cache, index);
+		}
+	}
 
-		p = static_cast<void**>(*prev);
+	void SizeClassAllocator::trim() {
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		//only the calling thread may touch its cache
+		auto& cache = caches_[util::threadSlot()];
+		for (size_t index = 0; index < CLASS_COUNT; index++) {
+			while (cache.freeLists[index] != nullptr) {
+				void *ptr = cache.freeLists[index];
+				cache.freeLists[index] = *static_cast<void**>(ptr);
+				*static_cast<void**>(ptr) = freeLists_[index];
+				freeLists_[index] = ptr;
+			}
+			cache.counts[index] = 0;
+		}
+		if (pageCount_ == 0) { return; }
+
+		//sort the pages by address so the page of a free slot can be found with a binary search
+		auto sorted = static_cast<PageHeader**>(parent_->allocate(pageCount_ * sizeof(PageHeader*)));
+		size_t count = 0;
+		for (PageHeader *p = pages_; p != nullptr; p = p->next) {
+			p->freeCount = 0;
+			sorted[count++] = p;
+		}
+		std::sort(sorted, sorted + count);
+		auto findPage = [sorted, count](void *ptr) {
+			return *(std::upper_bound(sorted, sorted + count, ptr, [](void *ptr, PageHeader *page) { return ptr < static_cast<void*>(page); }) - 1);
+		};
+		auto isFree = [this](const PageHeader *page) {
+			return page->freeCount == (pageSize_ - sizeof(PageHeader)) / classSize(page->index);
+		};
+
+		//count the free slots of every page
+		for (size_t index = 0; index < CLASS_COUNT; index++) {
+			for (void *ptr = freeLists_[index]; ptr != nullptr; ptr = *static_cast<void**>(ptr)) {
+				findPage(ptr)->freeCount++;
+			}
+		}
 
-		for (size_t i = 0; i < count - 1; i++) {
-			*p = ptrutil::add(p, objectSize_);
-			p = static_cast<void**>(*p);
+		//unlink the slots of free pages
+		for (size_t index = 0; index < CLASS_COUNT; index++) {
+			void **link = &freeLists_[index];
+			while (*link != nullptr) {
+				if (isFree(findPage(*link))) {
+					*link = *static_cast<void**>(*link);
+				} else {
+					link = static_cast<void**>(*link);
+				}
+			}
+		}
+
+		PageHeader **link = &pages_;
+		while (*link != nullptr) {
+			PageHeader *page = *link;
+			if (isFree(page)) {
+				*link = page->next;
+				parent_->deallocate(page, pageSize_);
+				pageCount_--;
+			} else {
+				link = &page->next;
+			}
 		}
 
-		*p = nullptr;
+		parent_->deallocate(sorted, count * sizeof(PageHeader*));
+	}
+
+	uint32_t SizeClassAllocator::batchSize(size_t index) {
+		//move around 8kb at a time
+		const size_t count = 8192 / classSize(index);
+		return static_cast<uint32_t>(count < 4 ? 4 : (count > 64 ? 64 : count));
+	}
+
+	void SizeClassAllocator::refill(ThreadCache& cache, size_t index) {
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		const uint32_t batch = batchSize(index);
+		for (uint32_t i = 0; i < batch; i++) {
+			if (freeLists_[index] == nullptr) {
+				grow(index);
+			}
+			void *ptr = freeLists_[index];
+			freeLists_[index] = *static_cast<void**>(ptr);
+			*static_cast<void**>(ptr) = cache.freeLists[index];
+			cache.freeLists[index] = ptr;
+		}
+		cache.counts[index] += batch;
+	}
+
+	void SizeClassAllocator::release(ThreadCache& cache, size_t index) {
+		//return a batch to the shared list so a thread that only frees does not hoard memory
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		const uint32_t batch = batchSize(index);
+		for (uint32_t i = 0; i < batch; i++) {
+			void *ptr = cache.freeLists[index];
+			cache.freeLists[index] = *static_cast<void**>(ptr);
+			*static_cast<void**>(ptr) = freeLists_[index];
+			freeLists_[index] = ptr;
+		}
+		cache.counts[index] -= batch;
+	}
+
+	void SizeClassAllocator::grow(size_t index) {
+		auto page = static_cast<PageHeader*>(parent_->allocate(pageSize_));
+		oak_assert(page != nullptr);
+		page->next = pages_;
+		page->index = static_cast<uint32_t>(index);
+		page->freeCount = 0;
+		pages_ = page;
+		pageCount_++;
+
+		//carve the page into slots and push them onto the free list in address order
+		const size_t size = classSize(index);
+		const size_t count = (pageSize_ - sizeof(PageHeader)) / size;
+		void *start = page + 1;
+		for (size_t i = 0; i < count - 1; i++) {
+			*static_cast<void**>(ptrutil::add(start, i * size)) = ptrutil::add(start, (i + 1) * size);
+		}
+		*static_cast<void**>(ptrutil::add(start, (count - 1) * size)) = freeLists_[index];
+		freeLists_[index] = start;
 	}
 
 }
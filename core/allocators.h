@@ -2,8 +2,11 @@
 
 #include <cstddef>
 #include <cinttypes>
+#include <mutex>
 
 #include "memory_literals.h"
+#include "memory_tag.h"
+#include "util/thread_id.h"
 
 namespace oak {
 
@@ -40,8 +43,17 @@ namespace oak {
 		void deallocate(void *ptr, size_t size) override;
 
 	private:
-		detail::Block *memList_;
+		//placed before every allocation so a block can be unlinked without searching,
+		//the header is padded to the alignment so the memory after it stays aligned
+		struct alignas(64) Header {
+			Header *prev;
+			Header *next;
+			size_t size;
+		};
+
+		Header *memList_;
 		size_t numAllocs_;
+		std::mutex mutex_;
 	};
 
 	class LinearAllocator : public Allocator {
@@ -63,6 +75,78 @@ namespace oak {
 		void grow();
 	};
 
+	//linear allocator over a reserved range of address space, pages are only committed as the arena grows
+	//so allocations are contiguous, never relinked and only limited by the size of the reservation
+	class VirtualArena : public Allocator {
+	public:
+		//committed pages are accounted against tag
+		VirtualArena(size_t reserveSize, size_t commitSize = 64_kb, size_t trimSize = 4_mb, uint32_t alignment = 16, MemoryTag tag = MemoryTag::GENERAL);
+		~VirtualArena();
+
+		VirtualArena(const VirtualArena&) = delete;
+		void operator=(const VirtualArena&) = delete;
+
+		void* allocate(size_t size) override;
+		void deallocate(void *ptr, size_t size) override;
+		//resets the arena, committed pages are kept unless far more were committed than were used since the last clear
+		void clear();
+		//gives committed pages past keep bytes back to the os, the address range stays reserved
+		void trim(size_t keep = 0);
+
+		inline void* getStart() const { return start_; }
+		inline size_t getUsed() const { return used_; }
+		inline size_t getCommitted() const { return committed_; }
+		inline size_t getReserved() const { return reserved_; }
+
+	protected:
+		void *start_;
+		size_t reserved_, committed_, used_;
+		size_t commitSize_, trimSize_;
+		MemoryTag tag_;
+	};
+
+	//last in first out allocator for scratch memory, everything allocated after a marker is released by rolling back to it
+	class StackAllocator : public VirtualArena {
+	public:
+		StackAllocator(size_t reserveSize = 64_mb, uint32_t alignment = 16);
+
+		//only the most recent allocation is released immediately, anything else waits for a rollback
+		void deallocate(void *ptr, size_t size) override;
+
+		inline size_t getMarker() const { return used_; }
+		void rollback(size_t marker);
+	};
+
+	//frame lifetime allocator, each thread bump allocates from its own arena so allocating needs no locks
+	//each arena reserves and commits its own address range, only the arena objects themselves are taken from the parent under a lock
+	class FrameAllocator : public Allocator {
+	public:
+		FrameAllocator(Allocator *parent, size_t reserveSize = 256_mb, uint32_t alignment = 8, MemoryTag tag = MemoryTag::GENERAL);
+		~FrameAllocator();
+
+		void* allocate(size_t size) override;
+		void deallocate(void *ptr, size_t size) override;
+		//resets the arena of every thread, no thread may be allocating while the allocator is cleared
+		void clear();
+
+	private:
+		//serializes access to the parent allocator for the arenas
+		class PageSource : public Allocator {
+		public:
+			PageSource(Allocator *parent);
+
+			void* allocate(size_t size) override;
+			void deallocate(void *ptr, size_t size) override;
+		private:
+			std::mutex mutex_;
+		};
+
+		size_t reserveSize_;
+		MemoryTag tag_;
+		PageSource pages_;
+		VirtualArena *arenas_[config::MAX_THREAD_SLOTS];
+	};
+
 	class FreelistAllocator : public Allocator {
 	public:
 		FreelistAllocator(Allocator *parent, size_t pageSize = 32_mb, uint32_t alignment = 8);
@@ -79,24 +163,118 @@ namespace oak {
 		size_t pageSize_;
 		void *start_;
 		detail::Block *freeList_;
+		//the freelist backs every oak container so it must be usable from worker threads
+		std::mutex mutex_;
 
 		void grow(detail::Block *lastNode);
 	};
 
+	//fixed size object allocator, objects are taken from pages that track how many of their slots are used
+	//pages are mapped from the os and unmapped once they become empty, one is kept around so an allocation right after doesnt need a new page
+	//the parent only holds the page index, mapped pages are accounted against tag
 	class PoolAllocator : public Allocator {
 	public:
-		PoolAllocator(Allocator *parent, size_t pageSize, size_t objectSize, uint32_t alignment = 8);
+		PoolAllocator(Allocator *parent, size_t pageSize, size_t objectSize, uint32_t alignment = 8, MemoryTag tag = MemoryTag::GENERAL);
 		~PoolAllocator();
 
 		void* allocate(size_t size) override;
 		void deallocate(void *ptr, size_t size) override;
+		//gives every empty page back to the os
+		void trim();
+
+		inline size_t getPageCount() const { return pageCount_; }
+		//bytes of mapped pages
+		inline size_t getCommitted() const { return pageCount_ * pageBytes_; }
+		inline size_t getObjectCount() const { return objectCount_; }
+		//fraction of the slots in the pages that are unused, 0 when every page is full
+		float getFragmentation() const;
+
 	private:
+		struct PageHeader {
+			//links pages that have free slots
+			PageHeader *prev, *next;
+			void *freeList;
+			uint32_t used;
+			//slots past this index have never been used
+			uint32_t bump;
+		};
+
 		size_t pageSize_;
 		size_t objectSize_;
-		void *start_;
-		void **freeList_;
+		size_t headerSize_;
+		//size of the mapping of a page, the header and slots rounded up to whole os pages
+		size_t pageBytes_;
+		uint32_t pageCapacity_;
+		size_t objectCount_;
+		MemoryTag tag_;
 
-		void grow();
+		PageHeader *partial_;
+		PageHeader *empty_;
+		//every page sorted by address so the page of an object can be found with a binary search
+		PageHeader **pages_;
+		size_t pageCount_, pagesCapacity_;
+
+		size_t pagesBefore(const void *ptr) const;
+		PageHeader* findPage(void *ptr) const;
+		PageHeader* addPage();
+		void removePage(PageHeader *page);
+		void unmapPage(PageHeader *page);
+		void link(PageHeader *page);
+		void unlink(PageHeader *page);
+	};
+
+	//segregated fit allocator, small allocations are rounded up to one of a fixed set of size classes
+	//and served from slabs of equally sized slots, larger allocations are passed to the parent
+	//sizes that are a multiple of 64 are 64 byte aligned, every other allocation is 16 byte aligned
+	//each thread keeps a cache of free slots per class so most allocations do not take the lock
+	//slab pages are kept until trim finds every slot of a page free and returns it to the parent
+	class SizeClassAllocator : public Allocator {
+	public:
+		static constexpr size_t CLASS_COUNT = 32;
+		static constexpr size_t MAX_SMALL_SIZE = 4096;
+
+		SizeClassAllocator(Allocator *parent, size_t pageSize = 64_kb);
+		~SizeClassAllocator();
+
+		void* allocate(size_t size) override;
+		void deallocate(void *ptr, size_t size) override;
+		//returns the slab pages whose slots are all free to the parent
+		//the calling threads cached slots are given back first, slots cached by other threads keep their pages
+		void trim();
+
+		inline size_t getPageCount() const { return pageCount_; }
+
+		//index of the size class that holds allocations of size bytes
+		static size_t sizeClass(size_t size);
+		static size_t classSize(size_t index);
+
+	private:
+		//slab pages start with a header that links them together, it is padded to keep the slots 64 byte aligned
+		struct alignas(64) PageHeader {
+			PageHeader *next;
+			uint32_t index;
+			//free slots of the page, only counted by trim
+			uint32_t freeCount;
+		};
+
+		//free slots owned by one thread
+		struct alignas(64) ThreadCache {
+			void *freeLists[CLASS_COUNT];
+			uint32_t counts[CLASS_COUNT];
+		};
+
+		size_t pageSize_;
+		void *freeLists_[CLASS_COUNT];
+		PageHeader *pages_;
+		size_t pageCount_;
+		std::mutex mutex_;
+		ThreadCache caches_[config::MAX_THREAD_SLOTS];
+
+		//number of slots moved between a thread cache and the shared lists at once
+		static uint32_t batchSize(size_t index);
+		void refill(ThreadCache& cache, size_t index);
+		void release(ThreadCache& cache, size_t index);
+		void grow(size_t index);
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "archetype_storage.h"
+
+#include "util/ptr_util.h"
+#include "type_manager.h"
+
+namespace oak {
+
+	EntityId* ArchetypeChunk::entities() {
+		return static_cast<EntityId*>(ptrutil::add(this, archetype->entityOffset));
+	}
+
+	void* ArchetypeChunk::components(size_t tid) {
+		oak_assert(archetype->mask[tid]);
+		return ptrutil::add(this, archetype->offsets[tid]);
+	}
+
+	ArchetypeStorage::ArchetypeStorage(Allocator *allocator) :
+		allocator_{ allocator, config::ARCHETYPE_CHUNK_SIZE * config::ARCHETYPE_CHUNKS_PER_PAGE, config::ARCHETYPE_CHUNK_SIZE, 16, MemoryTag::SCENE } {}
+
+	ArchetypeStorage::~ArchetypeStorage() {
+		for (auto archetype : archetypes_) {
+			for (auto chunk : archetype->chunks) {
+				for (auto tinfo : archetype->types) {
+					void *array = chunk->components(tinfo->id);
+					for (size_t i = 0; i < chunk->count; i++) {
+						tinfo->destruct(ptrutil::add(array, i * tinfo->size));
+					}
+				}
+				allocator_.deallocate(chunk, config::ARCHETYPE_CHUNK_SIZE);
+			}
+			archetype->~Archetype();
+			oalloc_tagged(MemoryTag::SCENE)->deallocate(archetype, sizeof(Archetype));
+		}
+		archetypes_.clear();
+		archetypeMap_.clear();
+	}
+
+	void ArchetypeStorage::setMask(EntityId entity, const std::bitset<config::MAX_COMPONENTS>& mask) {
+		if (locations_.size() <= entity.index) {
+			locations_.resize(entity.index + 1);
+		}
+		Location old = locations_[entity];
+		Archetype *oldArchetype = old.chunk ? old.chunk->archetype : nullptr;
+		if (oldArchetype != nullptr && oldArchetype->mask == mask) { return; }
+		if (oldArchetype == nullptr && mask.none()) { return; }
+
+		if (mask.none()) {
+			removeEntity(entity);
+			return;
+		}
+
+		Archetype *archetype = getArchetype(mask);
+		Location location = allocateSlot(entity, archetype);
+
+		if (oldArchetype != nullptr) {
+			//move shared components into the new slot and destroy the rest
+			for (auto tinfo : oldArchetype->types) {
+				void *src = ptrutil::add(old.chunk->components(tinfo->id), old.index * tinfo->size);
+				if (mask[tinfo->id]) {
+					void *dst = ptrutil::add(location.chunk->components(tinfo->id), location.index * tinfo->size);
+					tinfo->moveConstruct(dst, src);
+				}
+				tinfo->destruct(src);
+			}
+			removeSlot(old);
+		}
+		locations_[entity] = location;
+	}
+
+	void ArchetypeStorage::removeEntity(EntityId entity) {
+		if (locations_.size() <= entity.index) { return; }
+		Location location = locations_[entity];
+		if (location.chunk == nullptr) { return; }
+		for (auto tinfo : location.chunk->archetype->types) {
+			tinfo->destruct(ptrutil::add(location.chunk->components(tinfo->id), location.index * tinfo->size));
+		}
+		removeSlot(location);
+		locations_[entity] = {};
+	}
+
+	void* ArchetypeStorage::getComponent(EntityId entity, size_t tid) {
+		const Location& location = locations_[entity];
+		const auto archetype = location.chunk->archetype;
+		oak_assert(archetype->mask[tid]);
+		return ptrutil::add(location.chunk, archetype->offsets[tid] + location.index * archetype->sizes[tid]);
+	}
+
+	const void* ArchetypeStorage::getComponent(EntityId entity, size_t tid) const {
+		return const_cast<ArchetypeStorage*>(this)->getComponent(entity, tid);
+	}
+
+	Archetype* ArchetypeStorage::getArchetype(const std::bitset<config::MAX_COMPONENTS>& mask) {
+		auto it = archetypeMap_.find(mask);
+		if (it != std::end(archetypeMap_)) {
+			return it->second;
+		}
+
+		auto archetype = static_cast<Archetype*>(oalloc_tagged(MemoryTag::SCENE)->allocate(sizeof(Archetype)));
+		new (archetype) Archetype{};
+		archetype->mask = mask;
+
+		size_t rowSize = sizeof(EntityId);
+		for (size_t i = 0; i < config::MAX_COMPONENTS; i++) {
+			if (mask[i]) {
+				auto tinfo = ComponentTypeManager::inst().getTypeInfo(i);
+				archetype->types.push_back(tinfo);
+				rowSize += tinfo->size;
+			}
+		}
+
+		//leave room for the chunk header and for aligning each array
+		const size_t header = ptrutil::alignSize(sizeof(ArchetypeChunk), 16);
+		const size_t padding = 16 * (archetype->types.size() + 1);
+		oak_assert(config::ARCHETYPE_CHUNK_SIZE > header + padding + rowSize);
+		archetype->capacity = (config::ARCHETYPE_CHUNK_SIZE - header - padding) / rowSize;
+
+		size_t offset = header;
+		archetype->entityOffset = offset;
+		offset = ptrutil::alignSize(offset + sizeof(EntityId) * archetype->capacity, 16);
+		for (auto tinfo : archetype->types) {
+			archetype->offsets[tinfo->id] = offset;
+			archetype->sizes[tinfo->id] = tinfo->size;
+			offset = ptrutil::alignSize(offset + tinfo->size * archetype->capacity, 16);
+		}
+		oak_assert(offset <= config::ARCHETYPE_CHUNK_SIZE);
+
+		archetypes_.push_back(archetype);
+		archetypeMap_.insert({ mask, archetype });
+		return archetype;
+	}
+
+	ArchetypeStorage::Location ArchetypeStorage::allocateSlot(EntityId entity, Archetype *archetype) {
+		//entities are always packed at the end of the last chunk
+		if (archetype->chunks.empty() || archetype->chunks.back()->count == archetype->capacity) {
+			auto chunk = static_cast<ArchetypeChunk*>(allocator_.allocate(config::ARCHETYPE_CHUNK_SIZE));
+			chunk->archetype = archetype;
+			chunk->count = 0;
+			archetype->chunks.push_back(chunk);
+		}
+		auto chunk = archetype->chunks.back();
+		size_t index = chunk->count++;
+		chunk->entities()[index] = entity;
+		return { chunk, index };
+	}
+
+	void ArchetypeStorage::removeSlot(Location location) {
+		//fill the hole with the last entity in the archetype so the chunks stay packed
+		auto archetype = location.chunk->archetype;
+		auto last = archetype->chunks.back();
+		size_t lastIndex = last->count - 1;
+		if (location.chunk != last || location.index != lastIndex) {
+			for (auto tinfo : archetype->types) {
+				void *src = ptrutil::add(last->components(tinfo->id), lastIndex * tinfo->size);
+				void *dst = ptrutil::add(location.chunk->components(tinfo->id), location.index * tinfo->size);
+				tinfo->moveConstruct(dst, src);
+				tinfo->destruct(src);
+			}
+			EntityId moved = last->entities()[lastIndex];
+			location.chunk->entities()[location.index] = moved;
+			locations_[moved] = location;
+		}
+		last->count--;
+		if (last->count == 0) {
+			allocator_.deallocate(last, config::ARCHETYPE_CHUNK_SIZE);
+			archetype->chunks.pop_back();
+		}
+	}
+
+}
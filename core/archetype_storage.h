@@ -0,0 +1,96 @@
+#pragma once
+
+#include <bitset>
+#include <type_traits>
+
+#include "type_info.h"
+#include "entity_id.h"
+#include "component.h"
+#include "container.h"
+
+namespace oak {
+
+	namespace config {
+		constexpr size_t ARCHETYPE_CHUNK_SIZE = 16384;
+		constexpr size_t ARCHETYPE_CHUNKS_PER_PAGE = 16;
+	}
+
+	struct Archetype;
+
+	//fixed size block of entities that share a component mask
+	//the chunk header is followed by the entity ids and then one contiguous array per component type
+	struct ArchetypeChunk {
+		Archetype *archetype;
+		size_t count;
+
+		EntityId* entities();
+		void* components(size_t tid);
+
+		template<class T>
+		T* components() {
+			return static_cast<T*>(components(std::remove_const_t<T>::typeInfo.id));
+		}
+	};
+
+	struct Archetype {
+		std::bitset<config::MAX_COMPONENTS> mask;
+		//number of entities that fit in a chunk
+		size_t capacity;
+		//byte offset of each component array from the start of a chunk
+		size_t offsets[config::MAX_COMPONENTS];
+		size_t sizes[config::MAX_COMPONENTS];
+		size_t entityOffset;
+		oak::vector<const TypeInfo*> types;
+		oak::vector<ArchetypeChunk*> chunks;
+	};
+
+	class ArchetypeStorage {
+	public:
+		ArchetypeStorage(Allocator *allocator = oalloc_tagged(MemoryTag::SCENE));
+		~ArchetypeStorage();
+
+		//moves the entity into the archetype for mask, components in both archetypes are moved,
+		//components not in mask are destructed and new components are left uninitialized
+		void setMask(EntityId entity, const std::bitset<config::MAX_COMPONENTS>& mask);
+		void removeEntity(EntityId entity);
+
+		void* getComponent(EntityId entity, size_t tid);
+		const void* getComponent(EntityId entity, size_t tid) const;
+
+		//calls func(count, entities, components...) for every chunk with all the required components
+		//every entity that has the components is visited regardless of whether it is active
+		template<class... T, class F>
+		void forEachChunk(F&& func) {
+			std::bitset<config::MAX_COMPONENTS> filter;
+			(filter.set(std::remove_const_t<T>::typeInfo.id), ...);
+			for (auto archetype : archetypes_) {
+				if ((archetype->mask & filter) != filter) { continue; }
+				for (auto chunk : archetype->chunks) {
+					func(chunk->count, static_cast<const EntityId*>(chunk->entities()), chunk->components<T>()...);
+				}
+			}
+		}
+
+		inline const oak::vector<Archetype*>& getArchetypes() const { return archetypes_; }
+
+		//returns unused chunk pages to the parent allocator
+		inline void trim() { allocator_.trim(); }
+		inline float getFragmentation() const { return allocator_.getFragmentation(); }
+
+	private:
+		struct Location {
+			ArchetypeChunk *chunk = nullptr;
+			size_t index = 0;
+		};
+
+		oak::vector<Archetype*> archetypes_;
+		oak::unordered_map<std::bitset<config::MAX_COMPONENTS>, Archetype*> archetypeMap_;
+		oak::vector<Location> locations_;
+		PoolAllocator allocator_;
+
+		Archetype* getArchetype(const std::bitset<config::MAX_COMPONENTS>& mask);
+		Location allocateSlot(EntityId entity, Archetype *archetype);
+		void removeSlot(Location location);
+	};
+
+}
@@ -97,10 +97,47 @@ namespace oak {
 			[](const auto& inst){ return inst.flags & AudioObject::DONE; }), std::end(ud->playlist_));
 	}
 
+	const TypeInfo AudioObject::typeInfo = makeResourceInfo<AudioObject>("audio");
+
+	void pup(Puper& puper, AudioObject& data, const ObjInfo& info) {}
+
 	void AudioObject::destroy() {
 		AudioManager::inst().destroySound(*this);
 	}
 
+	static void freeSampler(detail::AudioSampler *sampler) {
+		if (sampler->buffer) {
+			oalloc_tagged(MemoryTag::AUDIO)->deallocate(sampler->buffer, sampler->length * sizeof(float));
+			sampler->buffer = nullptr;
+		}
+
+		if (sampler->vorbis) {
+			stb_vorbis_close(sampler->vorbis);
+			sampler->vorbis = nullptr;
+		}
+
+		sampler->detail::AudioSampler::~AudioSampler();
+		oalloc_tagged(MemoryTag::AUDIO)->deallocate(sampler, sizeof(detail::AudioSampler));
+	}
+
+	Sound::~Sound() {
+		if (sampler) {
+			freeSampler(sampler);
+		}
+	}
+
+	Sound::Sound(Sound&& other) {
+		*this = std::move(other);
+	}
+
+	void Sound::operator=(Sound&& other) {
+		if (sampler) {
+			freeSampler(sampler);
+		}
+		sampler = other.sampler;
+		other.sampler = nullptr;
+	}
+
 	AudioManager *AudioManager::instance = nullptr;
 
 	AudioManager::AudioManager() : channelCount_{ 2 } {
@@ -118,7 +155,7 @@ namespace oak {
 		disconnect();
 	}
 
-	void AudioManager::playSound(AudioObject& audio, uint32_t flags, float volume) {
+	void AudioManager::playSound(const AudioObject& audio, uint32_t flags, float volume) {
 		if (audio.id < 0) { return; }
 		auto sampler = samplers_[audio.id];
 		if (!hasToAdd_.load()) {
@@ -128,15 +165,23 @@ namespace oak {
 	}
 
 	AudioObject AudioManager::createSound(const oak::string& path) {
+		auto sound = decodeSound(path);
+		return createSound(sound);
+	}
+
+	Sound AudioManager::decodeSound(const oak::string& path) {
 		auto resolvedPath = FileManager::inst().resolvePath(path);
+		Sound sound;
 		//allocate sound data
-		detail::AudioSampler *sampler = static_cast<detail::AudioSampler*>(oalloc_freelist.allocate(sizeof(detail::AudioSampler)));
+		detail::AudioSampler *sampler = static_cast<detail::AudioSampler*>(oalloc_tagged(MemoryTag::AUDIO)->allocate(sizeof(detail::AudioSampler)));
 		new (sampler) detail::AudioSampler{};
+		sound.sampler = sampler;
 
 		sampler->vorbis = stb_vorbis_open_filename(resolvedPath.c_str(), nullptr, nullptr);
 		if (!sampler->vorbis) {
+			//this can run on a loader thread so a missing file gives an empty sound instead of aborting
 			log_print_err("failed to open audio file: %s", path.c_str());
-			abort();
+			return {};
 		}
 
 		sampler->info = stb_vorbis_get_info(sampler->vorbis);
@@ -144,33 +189,28 @@ namespace oak {
 		size_t length = stb_vorbis_stream_length_in_samples(sampler->vorbis);
 
 		if (length < 1000000) {
-			sampler->buffer = static_cast<float*>(oalloc_freelist.allocate(length * sizeof(float)));
+			sampler->buffer = static_cast<float*>(oalloc_tagged(MemoryTag::AUDIO)->allocate(length * sizeof(float)));
 			stb_vorbis_get_samples_float_interleaved(sampler->vorbis, 1, sampler->buffer, length);
 			sampler->length = length;
 		}
 
-		samplers_.push_back(sampler);
+		return sound;
+	}
+
+	AudioObject AudioManager::createSound(Sound& sound) {
+		if (!sound.sampler) { return {}; }
+		samplers_.push_back(sound.sampler);
+		sound.sampler = nullptr;
 		return { static_cast<int>(samplers_.size() - 1) };
 	}
 
 	void AudioManager::destroySound(AudioObject& audio) {
 		if (audio.id < 0) { return; }
-		auto& sampler = samplers_[audio.id];
+		auto sampler = samplers_[audio.id];
 
 		samplers_.erase(std::remove(std::begin(samplers_), std::end(samplers_), sampler), std::end(samplers_));
 
-		if (sampler->buffer) {
-			oalloc_freelist.deallocate(sampler->buffer, sampler->length * sizeof(float));
-			sampler->buffer = nullptr;
-		}
-
-		if (sampler->vorbis) {
-			stb_vorbis_close(sampler->vorbis);
-			sampler->vorbis = nullptr;
-		}
-
-		sampler->detail::AudioSampler::~AudioSampler();
-		oalloc_freelist.deallocate(sampler, sizeof(detail::AudioSampler));
+		freeSampler(sampler);
 	}
 
 	void AudioManager::update() {
@@ -5,6 +5,7 @@
 
 #include "oak_assert.h"
 #include "container.h"
+#include "resource.h"
 
 struct SoundIo;
 struct SoundIoDevice;
@@ -24,6 +25,8 @@ namespace oak {
 	}
 
 	struct AudioObject {
+		static const TypeInfo typeInfo;
+
 		enum Flag: uint32_t {
 			LOOP = 0x01,
 			PAUSED = 0x02,
@@ -34,6 +37,22 @@ namespace oak {
 		void destroy();
 	};
 
+	void pup(Puper& puper, AudioObject& data, const ObjInfo& info);
+
+	//samples decoded from a sound file, decoding does not touch the audio device so it can run on a loader thread
+	struct Sound {
+		Sound() = default;
+		~Sound();
+
+		Sound(const Sound&) = delete;
+		void operator=(const Sound&) = delete;
+
+		Sound(Sound&& other);
+		void operator=(Sound&& other);
+
+		detail::AudioSampler *sampler = nullptr;
+	};
+
 	class AudioManager {
 		friend void write_callback(SoundIoOutStream*, int, int);
 	private:
@@ -51,8 +70,11 @@ namespace oak {
 
 		void update();
 
-		void playSound(AudioObject& audio, uint32_t flags, float volume);
+		void playSound(const AudioObject& audio, uint32_t flags, float volume);
 		AudioObject createSound(const oak::string& path);		
+		//create split in two, decodeSound can be called from any thread and createSound takes the decoded samples
+		static Sound decodeSound(const oak::string& path);
+		AudioObject createSound(Sound& sound);
 		void destroySound(AudioObject& audio);
 
 	private:
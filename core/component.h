@@ -10,6 +10,13 @@ namespace oak {
 		constexpr size_t MAX_COMPONENTS = 64;
 	}
 
+	//how a scene lays out its components in memory
+	enum class StorageMode {
+		POOL, //one pool allocated slot per component
+		SPARSE, //packed array per component type indexed through a paged sparse array, removal swaps with the last component
+		ARCHETYPE //entities with the same component mask share chunks with one array per component type
+	};
+
 	namespace detail {
 		struct BaseComponent {};
 	}
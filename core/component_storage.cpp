@@ -1,13 +1,21 @@
 #include "component_storage.h"
 
+#include <cstring>
+
 #include "type_info.h"
 #include "component.h"
+#include "archetype_storage.h"
+#include "util/ptr_util.h"
 
 namespace oak {
 
-	ComponentStorage::ComponentStorage(const TypeInfo *tinfo) : 
+	ComponentStorage::ComponentStorage(const TypeInfo *tinfo, StorageMode mode, ArchetypeStorage *archetypes) : 
 		typeInfo_{ tinfo }, 
-		allocator_{ &oalloc_freelist, 8192, tinfo->size, 8 } {}
+		mode_{ mode },
+		archetypes_{ archetypes },
+		allocator_{ oalloc_tagged(MemoryTag::SCENE), 8192, tinfo->size, 8, MemoryTag::SCENE } {
+		oak_assert((mode_ == StorageMode::ARCHETYPE) == (archetypes_ != nullptr));
+	}
 
 	ComponentStorage::~ComponentStorage() {
 		size_t size = typeInfo_->size;
@@ -16,30 +24,76 @@ namespace oak {
 				allocator_.deallocate(component, size);
 			}
 		}
+
+		for (size_t i = 0; i < entities_.size(); i++) {
+			typeInfo_->destruct(getDense(i));
+		}
+		for (auto page : dense_) {
+			oalloc_tagged(MemoryTag::SCENE)->deallocate(page, config::DENSE_PAGE_SIZE * size);
+		}
+		for (auto page : sparse_) {
+			if (page != nullptr) {
+				oalloc_tagged(MemoryTag::SCENE)->deallocate(page, config::SPARSE_PAGE_SIZE * sizeof(uint32_t));
+			}
+		}
+	}
+
+	void ComponentStorage::trim() {
+		allocator_.trim();
+		//free the dense pages past the last component
+		const size_t pages = (entities_.size() + config::DENSE_PAGE_SIZE - 1) / config::DENSE_PAGE_SIZE;
+		while (dense_.size() > pages) {
+			oalloc_tagged(MemoryTag::SCENE)->deallocate(dense_.back(), config::DENSE_PAGE_SIZE * typeInfo_->size);
+			dense_.pop_back();
+		}
 	}
 
 	void* ComponentStorage::addComponent(EntityId entity) {
-		auto component = makeValid(entity);
+		oak_assert(archetypes_ == nullptr);
+		auto component = mode_ == StorageMode::SPARSE ? makeDense(entity) : makeValid(entity);
 		typeInfo_->construct(component);
 		return component;
 	}
 
 	void ComponentStorage::addComponent(EntityId entity, const void *ptr) {
-		auto component = makeValid(entity);
+		oak_assert(archetypes_ == nullptr);
+		auto component = mode_ == StorageMode::SPARSE ? makeDense(entity) : makeValid(entity);
 		typeInfo_->copyConstruct(component, ptr);
 	}
 
 	void ComponentStorage::removeComponent(EntityId entity) {
+		oak_assert(archetypes_ == nullptr);
+		if (mode_ == StorageMode::SPARSE) {
+			removeDense(entity);
+			return;
+		}
 		auto component = components_[entity];
 		typeInfo_->destruct(component);
 	}
 
 	void* ComponentStorage::getComponent(EntityId entity) {
-		return components_[entity];
+		switch (mode_) {
+			case StorageMode::ARCHETYPE:
+				return archetypes_->getComponent(entity, typeInfo_->id);
+			case StorageMode::SPARSE: {
+				uint32_t index = findDense(entity);
+				return index == INVALID_INDEX ? nullptr : getDense(index);
+			}
+			default:
+				return components_[entity];
+		}
 	}
 
 	const void* ComponentStorage::getComponent(EntityId entity) const {
-		return components_[entity];
+		return const_cast<ComponentStorage*>(this)->getComponent(entity);
+	}
+
+	void* ComponentStorage::getDense(size_t index) {
+		return ptrutil::add(dense_[index / config::DENSE_PAGE_SIZE], (index & (config::DENSE_PAGE_SIZE - 1)) * typeInfo_->size);
+	}
+
+	const void* ComponentStorage::getDense(size_t index) const {
+		return const_cast<ComponentStorage*>(this)->getDense(index);
 	}
 
 	void* ComponentStorage::makeValid(EntityId entity) {
@@ -53,4 +107,63 @@ namespace oak {
 		return component;
 	}
 
+	void* ComponentStorage::makeDense(EntityId entity) {
+		auto& index = sparseIndex(entity);
+		if (index != INVALID_INDEX) {
+			//the entity already has a slot, destroy the old value so it can be replaced
+			void *component = getDense(index);
+			typeInfo_->destruct(component);
+			return component;
+		}
+
+		if (entities_.size() == dense_.size() * config::DENSE_PAGE_SIZE) {
+			//the dense array grows a page at a time so existing components never move
+			dense_.push_back(oalloc_tagged(MemoryTag::SCENE)->allocate(config::DENSE_PAGE_SIZE * typeInfo_->size));
+		}
+
+		index = static_cast<uint32_t>(entities_.size());
+		entities_.push_back(entity);
+		return getDense(index);
+	}
+
+	void ComponentStorage::removeDense(EntityId entity) {
+		auto& index = sparseIndex(entity);
+		oak_assert(index != INVALID_INDEX);
+
+		//swap the last component into the hole so the array stays packed
+		void *component = getDense(index);
+		typeInfo_->destruct(component);
+		const uint32_t last = static_cast<uint32_t>(entities_.size() - 1);
+		if (index != last) {
+			void *src = getDense(last);
+			typeInfo_->moveConstruct(component, src);
+			typeInfo_->destruct(src);
+			EntityId moved = entities_[last];
+			entities_[index] = moved;
+			sparseIndex(moved) = index;
+		}
+		entities_.pop_back();
+		index = INVALID_INDEX;
+	}
+
+	uint32_t& ComponentStorage::sparseIndex(EntityId entity) {
+		const size_t page = entity.index / config::SPARSE_PAGE_SIZE;
+		if (sparse_.size() <= page) {
+			sparse_.resize(page + 1, nullptr);
+		}
+		auto& ptr = sparse_[page];
+		if (ptr == nullptr) {
+			//pages are only allocated for ranges of entity indices that are used
+			ptr = static_cast<uint32_t*>(oalloc_tagged(MemoryTag::SCENE)->allocate(config::SPARSE_PAGE_SIZE * sizeof(uint32_t)));
+			std::memset(ptr, 0xff, config::SPARSE_PAGE_SIZE * sizeof(uint32_t));
+		}
+		return ptr[entity.index & (config::SPARSE_PAGE_SIZE - 1)];
+	}
+
+	uint32_t ComponentStorage::findDense(EntityId entity) const {
+		const size_t page = entity.index / config::SPARSE_PAGE_SIZE;
+		if (sparse_.size() <= page || sparse_[page] == nullptr) { return INVALID_INDEX; }
+		return sparse_[page][entity.index & (config::SPARSE_PAGE_SIZE - 1)];
+	}
+
 }
@@ -2,15 +2,23 @@
 
 #include "type_info.h"
 #include "entity_id.h"
+#include "component.h"
 #include "container.h"
 
 namespace oak {
 
+	namespace config {
+		constexpr size_t SPARSE_PAGE_SIZE = 4096; //entity indices per sparse page, must be a power of 2
+		constexpr size_t DENSE_PAGE_SIZE = 1024; //components per dense page, must be a power of 2
+	}
+
 	class TypeHandleBase;
+	class ArchetypeStorage;
 
 	class ComponentStorage {
 	public:
-		ComponentStorage(const TypeInfo *tinfo);
+		//if archetypes is given the components are owned by the archetype storage and this only provides lookups
+		ComponentStorage(const TypeInfo *tinfo, StorageMode mode = StorageMode::POOL, ArchetypeStorage *archetypes = nullptr);
 		~ComponentStorage();
 
 		void* addComponent(EntityId entity);
@@ -21,13 +29,41 @@ namespace oak {
 		const void* getComponent(EntityId entity) const;
 
 		const TypeInfo* getTypeInfo() const { return typeInfo_; }
+		StorageMode getMode() const { return mode_; }
+
+		//returns unused pages to the parent allocator
+		void trim();
+		inline float getFragmentation() const { return allocator_.getFragmentation(); }
+
+		//packed component values and their owning entities, only valid in sparse mode
+		//the values are stored in pages of config::DENSE_PAGE_SIZE components
+		//removing a component moves the last component into its place so pointers are only valid until the next removal
+		inline size_t getSize() const { return entities_.size(); }
+		void* getDense(size_t index);
+		const void* getDense(size_t index) const;
+		inline const oak::vector<EntityId>& getEntities() const { return entities_; }
 
 	private:
+		static constexpr uint32_t INVALID_INDEX = ~uint32_t{ 0 };
+
 		const TypeInfo *typeInfo_;
+		StorageMode mode_;
+		ArchetypeStorage *archetypes_;
+
+		//pool mode
 		PoolAllocator allocator_;
 		oak::vector<void*> components_;
 
+		//sparse mode
+		oak::vector<uint32_t*> sparse_;
+		oak::vector<EntityId> entities_;
+		oak::vector<void*> dense_;
+
 		void* makeValid(EntityId entity);
+		void* makeDense(EntityId entity);
+		void removeDense(EntityId entity);
+		uint32_t& sparseIndex(EntityId entity);
+		uint32_t findDense(EntityId entity) const;
 	};
 
 }
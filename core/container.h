@@ -1,12 +1,16 @@
 #pragma once
 
 #include <array>
+#include <cstring>
 #include <vector>
 #include <deque>
 #include <string>
 #include <unordered_map>
+#include <string_view>
+#include <utility>
 #include <scoped_allocator>
 
+#include "oak_assert.h"
 #include "oak_alloc.h"
 
 namespace oak {
@@ -30,8 +34,9 @@ namespace std {
 
 	template<>
 	struct hash<oak::string> {
+		//hashes the characters in place, the hash is the same as the std::string hash
 		size_t operator()(const oak::string& value) const {
-			return std::hash<std::string>{}(value.c_str());
+			return std::hash<std::string_view>{}(std::string_view{ value.data(), value.size() });
 		}
 	};
 
@@ -42,4 +47,267 @@ namespace oak {
 
 	template<class U, class T>
 	using unordered_map = std::unordered_map<U, T, std::hash<U>, std::equal_to<U>, detail::oalloc<std::pair<const U, T>>>;
-}
+
+	//open addressing hash map, the entries are stored in one flat array and probed linearly (robin hood)
+	//lookups touch one or two cache lines instead of following a node pointer for every entry
+	//inserting or erasing moves entries so both invalidate iterators and references
+	template<class K, class V, class Hash = std::hash<K>, class Eq = std::equal_to<K>>
+	class hash_map {
+	public:
+		using value_type = std::pair<K, V>;
+
+		template<class E, class M>
+		class iterator_base {
+		public:
+			iterator_base(E *entries, M *dists, size_t index, size_t capacity) : entries_{ entries }, dists_{ dists }, index_{ index }, capacity_{ capacity } {
+				skip();
+			}
+
+			inline E& operator*() const { return entries_[index_]; }
+			inline E* operator->() const { return entries_ + index_; }
+
+			inline iterator_base& operator++() {
+				index_++;
+				skip();
+				return *this;
+			}
+
+			inline bool operator==(const iterator_base& other) const { return index_ == other.index_; }
+			inline bool operator!=(const iterator_base& other) const { return index_ != other.index_; }
+
+			inline size_t index() const { return index_; }
+
+		private:
+			E *entries_;
+			M *dists_;
+			size_t index_;
+			size_t capacity_;
+
+			inline void skip() {
+				while (index_ < capacity_ && dists_[index_] == 0) { index_++; }
+			}
+		};
+
+		using iterator = iterator_base<value_type, uint16_t>;
+		using const_iterator = iterator_base<const value_type, const uint16_t>;
+
+		explicit hash_map(Allocator *allocator = &oalloc_sizeclass) : allocator_{ allocator } {}
+
+		~hash_map() {
+			destroy();
+		}
+
+		hash_map(const hash_map& other) : allocator_{ other.allocator_ } {
+			*this = other;
+		}
+
+		hash_map& operator=(const hash_map& other) {
+			if (this == &other) { return *this; }
+			clear();
+			reserve(other.size_);
+			for (const auto& it : other) {
+				insert(it);
+			}
+			return *this;
+		}
+
+		hash_map(hash_map&& other) : allocator_{ other.allocator_ } {
+			*this = std::move(other);
+		}
+
+		hash_map& operator=(hash_map&& other) {
+			if (this == &other) { return *this; }
+			destroy();
+			allocator_ = other.allocator_;
+			entries_ = other.entries_;
+			dists_ = other.dists_;
+			capacity_ = other.capacity_;
+			size_ = other.size_;
+			other.entries_ = nullptr;
+			other.dists_ = nullptr;
+			shift_ = other.shift_;
+			other.capacity_ = 0;
+			other.size_ = 0;
+			return *this;
+		}
+
+		inline iterator begin() { return { entries_, dists_, 0, capacity_ }; }
+		inline iterator end() { return { entries_, dists_, capacity_, capacity_ }; }
+		inline const_iterator begin() const { return { entries_, dists_, 0, capacity_ }; }
+		inline const_iterator end() const { return { entries_, dists_, capacity_, capacity_ }; }
+
+		inline size_t size() const { return size_; }
+		inline bool empty() const { return size_ == 0; }
+		inline size_t capacity() const { return capacity_; }
+
+		iterator find(const K& key) {
+			return { entries_, dists_, lookup(key), capacity_ };
+		}
+
+		const_iterator find(const K& key) const {
+			return { entries_, dists_, lookup(key), capacity_ };
+		}
+
+		inline size_t count(const K& key) const { return lookup(key) != capacity_ ? 1 : 0; }
+
+		V& operator[](const K& key) {
+			size_t index = lookup(key);
+			if (index == capacity_) {
+				index = emplace(K{ key }, V{});
+			}
+			return entries_[index].second;
+		}
+
+		std::pair<iterator, bool> insert(const value_type& value) {
+			size_t index = lookup(value.first);
+			if (index != capacity_) {
+				return { { entries_, dists_, index, capacity_ }, false };
+			}
+			index = emplace(K{ value.first }, V{ value.second });
+			return { { entries_, dists_, index, capacity_ }, true };
+		}
+
+		void erase(iterator it) {
+			eraseAt(it.index());
+		}
+
+		size_t erase(const K& key) {
+			size_t index = lookup(key);
+			if (index == capacity_) { return 0; }
+			eraseAt(index);
+			return 1;
+		}
+
+		void clear() {
+			for (size_t i = 0; i < capacity_; i++) {
+				if (dists_[i] != 0) {
+					entries_[i].~value_type();
+					dists_[i] = 0;
+				}
+			}
+			size_ = 0;
+		}
+
+		void reserve(size_t count) {
+			size_t capacity = capacity_ == 0 ? 8 : capacity_;
+			while (count * 8 > capacity * 7) {
+				capacity *= 2;
+			}
+			if (capacity != capacity_) {
+				rehash(capacity);
+			}
+		}
+
+	private:
+		//dists_ stores the probe distance of each entry plus one, zero marks an empty slot
+		static constexpr uint32_t MAX_DIST = 0xffff;
+
+		Allocator *allocator_;
+		value_type *entries_ = nullptr;
+		uint16_t *dists_ = nullptr;
+		size_t capacity_ = 0;
+		size_t size_ = 0;
+		//64 - log2(capacity)
+		uint32_t shift_ = 64;
+
+		inline size_t home(const K& key) const {
+			//fibonacci hashing spreads identity hashes (eg. small integer ids) over the table
+			return (Hash{}(key) * 11400714819323198485ull) >> shift_;
+		}
+
+		size_t lookup(const K& key) const {
+			if (size_ == 0) { return capacity_; }
+			const size_t mask = capacity_ - 1;
+			size_t index = home(key);
+			for (uint32_t dist = 1; dist <= dists_[index]; dist++) {
+				if (dists_[index] == dist && Eq{}(entries_[index].first, key)) {
+					return index;
+				}
+				index = (index + 1) & mask;
+			}
+			return capacity_;
+		}
+
+		size_t emplace(K&& key, V&& value) {
+			if ((size_ + 1) * 8 > capacity_ * 7) {
+				rehash(capacity_ == 0 ? 8 : capacity_ * 2);
+			}
+			const size_t mask = capacity_ - 1;
+			size_t index = home(key);
+			uint32_t dist = 1;
+			size_t result = capacity_;
+			value_type entry{ std::move(key), std::move(value) };
+			//entries closer to their home give up their slot to the entry being placed
+			while (dists_[index] != 0) {
+				if (dists_[index] < dist) {
+					if (result == capacity_) { result = index; }
+					std::swap(entry, entries_[index]);
+					const uint32_t d = dists_[index];
+					dists_[index] = static_cast<uint16_t>(dist);
+					dist = d;
+				}
+				index = (index + 1) & mask;
+				dist++;
+				//only reachable with a hash that maps thousands of keys to the same slot
+				oak_assert(dist <= MAX_DIST);
+			}
+			new (entries_ + index) value_type{ std::move(entry) };
+			dists_[index] = static_cast<uint16_t>(dist);
+			size_++;
+			return result == capacity_ ? index : result;
+		}
+
+		void eraseAt(size_t index) {
+			const size_t mask = capacity_ - 1;
+			entries_[index].~value_type();
+			dists_[index] = 0;
+			size_--;
+			//shift the following entries back so lookups do not need tombstones
+			size_t next = (index + 1) & mask;
+			while (dists_[next] > 1) {
+				new (entries_ + index) value_type{ std::move(entries_[next]) };
+				entries_[next].~value_type();
+				dists_[index] = dists_[next] - 1;
+				dists_[next] = 0;
+				index = next;
+				next = (next + 1) & mask;
+			}
+		}
+
+		void rehash(size_t capacity) {
+			value_type *entries = entries_;
+			uint16_t *dists = dists_;
+			const size_t oldCapacity = capacity_;
+
+			//entries and probe distances share one allocation
+			entries_ = static_cast<value_type*>(allocator_->allocate(capacity * (sizeof(value_type) + sizeof(uint16_t))));
+			dists_ = reinterpret_cast<uint16_t*>(entries_ + capacity);
+			memset(dists_, 0, capacity * sizeof(uint16_t));
+			capacity_ = capacity;
+			size_ = 0;
+			shift_ = 64;
+			while ((size_t{ 1 } << (64 - shift_)) < capacity) { shift_--; }
+
+			for (size_t i = 0; i < oldCapacity; i++) {
+				if (dists[i] != 0) {
+					emplace(std::move(entries[i].first), std::move(entries[i].second));
+					entries[i].~value_type();
+				}
+			}
+			if (entries != nullptr) {
+				allocator_->deallocate(entries, oldCapacity * (sizeof(value_type) + sizeof(uint16_t)));
+			}
+		}
+
+		void destroy() {
+			clear();
+			if (entries_ != nullptr) {
+				allocator_->deallocate(entries_, capacity_ * (sizeof(value_type) + sizeof(uint16_t)));
+			}
+			entries_ = nullptr;
+			dists_ = nullptr;
+			capacity_ = 0;
+		}
+	};
+
+}
\ No newline at end of file
@@ -1,10 +1,11 @@
 #include <cstddef>
+#include <atomic>
 
 namespace oak::debug::vars {
 
 	float dt = 0.0f;
 	float fps = 0.0f;
-	size_t usedMemory = 0;
-	size_t allocatedMemory = 0;
+	std::atomic<size_t> usedMemory{ 0 };
+	std::atomic<size_t> allocatedMemory{ 0 };
 
 }
\ No newline at end of file
@@ -1,7 +1,5 @@
 #include "entity_cache.h"
 
-#include <algorithm>
-
 #include "oakengine.h"
 #include "event_queue.h"
 #include "scene_events.h"
@@ -9,14 +7,11 @@
 namespace oak {
 
 	void EntityCache::update(const Scene& scene) {
-		bool needsSort = false;
-
 		for (const auto& evt : getEventQueue<EntityDeactivateEvent>()) {
 			ensureSize(evt.entity.index);
 			//if the entity is contained then remove it
-			if (contains_[evt.entity]) {
+			if (contains(evt.entity)) {
 				removeEntity(evt.entity);
-				needsSort = true;
 			}
 		}
 
@@ -25,46 +20,57 @@ namespace oak {
 			//check if the entity matches the filter
 			const auto& compFilter = scene.getComponentFilter(evt.entity);
 			if (filter(scene, evt.entity, compFilter)) {
-				if (!contains_[evt.entity]) {
+				if (!contains(evt.entity)) {
 					addEntity(evt.entity);
-					needsSort = true;
 				}
 			} else {
-				if (contains_[evt.entity]) {
+				if (contains(evt.entity)) {
 					removeEntity(evt.entity);
-					needsSort = true;
 				}
 			}
 		}
+	}
 
-		if (needsSort) {
-			sort();
+	void EntityCache::refresh(const Scene& scene) {
+		clear();
+		for (const auto& entity : scene.getEntities()) {
+			if (!scene.isEntityActive(entity)) { continue; }
+			ensureSize(entity.index);
+			if (filter(scene, entity, scene.getComponentFilter(entity))) {
+				addEntity(entity);
+			}
 		}
 	}
 
-	bool EntityCache::contains(EntityId entity) {
-		return contains_.size() > entity.index && contains_[entity];
+	bool EntityCache::contains(EntityId entity) const {
+		return indices_.size() > entity.index && indices_[entity] != INVALID_INDEX;
+	}
+
+	void EntityCache::clear() {
+		for (const auto& entity : entities_) {
+			indices_[entity] = INVALID_INDEX;
+		}
+		entities_.clear();
 	}
 
 	void EntityCache::addEntity(EntityId entity) {
+		indices_[entity] = static_cast<uint32_t>(entities_.size());
 		entities_.push_back(entity);
-		contains_[entity] = true;
 	}
 
 	void EntityCache::removeEntity(EntityId entity) {
-		entities_.erase(std::remove(std::begin(entities_), std::end(entities_), entity), std::end(entities_));
-		contains_[entity] = false;
-	}
-
-	void EntityCache::sort() {
-		std::sort(std::begin(entities_), std::end(entities_), [](const EntityId& first, const EntityId& second) {
-			return first.index < second.index;
-		});
+		//move the last entity into the removed entities slot
+		const uint32_t index = indices_[entity];
+		const EntityId last = entities_.back();
+		entities_[index] = last;
+		indices_[last] = index;
+		entities_.pop_back();
+		indices_[entity] = INVALID_INDEX;
 	}
 
 	void EntityCache::ensureSize(size_t size) {
-		if (contains_.size() <= size) {
-			contains_.resize(size + 1);
+		if (indices_.size() <= size) {
+			indices_.resize(size + 1, INVALID_INDEX);
 		}
 	}
 
@@ -74,4 +80,48 @@ namespace oak {
 				getComponent<const PrefabComponent>(entity, scene).id == prefabFilter_ :
 				true);
 	}
+
+	QueryRegistry::~QueryRegistry() {
+		for (auto cache : caches_) {
+			cache->~EntityCache();
+			oalloc_tagged(MemoryTag::SCENE)->deallocate(cache, sizeof(EntityCache));
+		}
+		caches_.clear();
+	}
+
+	const EntityCache& QueryRegistry::get(const Scene& scene, const std::bitset<config::MAX_COMPONENTS>& componentFilter, size_t prefabFilter) {
+		std::bitset<config::MAX_COMPONENTS> filter = componentFilter;
+		if (prefabFilter != 0) {
+			filter[PrefabComponent::typeInfo.id] = true;
+		}
+		for (auto cache : caches_) {
+			if (cache->getComponentFilter() == filter && cache->getPrefabFilter() == prefabFilter) {
+				return *cache;
+			}
+		}
+
+		auto cache = static_cast<EntityCache*>(oalloc_tagged(MemoryTag::SCENE)->allocate(sizeof(EntityCache)));
+		new (cache) EntityCache{};
+		cache->requireComponents(filter);
+		if (prefabFilter != 0) {
+			cache->requirePrefab(prefabFilter);
+		}
+		//entities may have been activated before the query was made
+		cache->refresh(scene);
+		caches_.push_back(cache);
+		return *cache;
+	}
+
+	void QueryRegistry::update(const Scene& scene) {
+		for (auto cache : caches_) {
+			cache->update(scene);
+		}
+	}
+
+	void QueryRegistry::clear() {
+		for (auto cache : caches_) {
+			cache->clear();
+		}
+	}
+
 }
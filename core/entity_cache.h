@@ -12,14 +12,18 @@ namespace oak {
 
 	class Scene;
 
+	//set of active entities that match a component filter
+	//adding and removing entities is constant time, the order of entities() is unspecified
 	class EntityCache {
 	public:
 
 		void update(const Scene& scene);
-		bool contains(EntityId entity);
+		//rebuilds the cache from every active entity in the scene
+		void refresh(const Scene& scene);
+		bool contains(EntityId entity) const;
 
 		inline const oak::vector<EntityId>& entities() const { return entities_; }
-		inline void clear() { entities_.clear(); };
+		void clear();
 		
 		template<class T>
 		inline void requireComponent() {
@@ -31,18 +35,52 @@ namespace oak {
 			prefabFilter_ = id;
 		}
 
+		inline void requireComponents(const std::bitset<config::MAX_COMPONENTS>& filter) {
+			componentFilter_ |= filter;
+		}
+
+		inline const std::bitset<config::MAX_COMPONENTS>& getComponentFilter() const { return componentFilter_; }
+		inline size_t getPrefabFilter() const { return prefabFilter_; }
+
 
 	private:
+		static constexpr uint32_t INVALID_INDEX = ~uint32_t{ 0 };
+
 		oak::vector<EntityId> entities_;
-		oak::vector<bool> contains_;
+		//position of each entity in entities_ indexed by entity index
+		oak::vector<uint32_t> indices_;
 		std::bitset<config::MAX_COMPONENTS> componentFilter_;
 		size_t prefabFilter_ = 0;
 
 		void addEntity(EntityId entity);
 		void removeEntity(EntityId entity);
-		void sort();
 		void ensureSize(size_t size);
 		bool filter(const Scene& scene, EntityId entity, const std::bitset<config::MAX_COMPONENTS>& compFilter);
 	};
 
+	//owns one entity cache per unique (component filter, prefab filter) pair so systems that
+	//require the same components share a single cache that is updated once per frame
+	class QueryRegistry {
+	public:
+		~QueryRegistry();
+
+		//returns the cache for the filter, creating and filling it if it does not exist yet
+		const EntityCache& get(const Scene& scene, const std::bitset<config::MAX_COMPONENTS>& componentFilter, size_t prefabFilter = 0);
+
+		template<class... T>
+		const EntityCache& get(const Scene& scene, size_t prefabFilter = 0) {
+			std::bitset<config::MAX_COMPONENTS> filter;
+			(filter.set(T::typeInfo.id), ...);
+			return get(scene, filter, prefabFilter);
+		}
+
+		void update(const Scene& scene);
+		void clear();
+
+		inline size_t size() const { return caches_.size(); }
+
+	private:
+		oak::vector<EntityCache*> caches_;
+	};
+
 }
@@ -6,6 +6,10 @@
 
 namespace oak {
 
+	namespace config {
+		constexpr size_t MAX_EVENTS = 64;
+	}
+
 	namespace detail {
 		struct BaseEvent {};
 	}
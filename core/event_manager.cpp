@@ -13,7 +13,7 @@ namespace oak {
 	EventManager::~EventManager() {
 		for (auto& queue : queues_) {
 			queue->~EventQueueBase();
-			oak_allocator.deallocate(queue, sizeof(EventQueueBase));
+			oalloc_tagged(MemoryTag::EVENTS)->deallocate(queue, sizeof(EventQueueBase));
 		}
 		queues_.clear();
 		instance = nullptr;
@@ -25,10 +25,12 @@ namespace oak {
 		}
 	}
 
-	void EventManager::addQueue(const TypeInfo *tinfo) {
+	void EventManager::addQueue(const TypeInfo *tinfo, bool doubleBuffered, size_t reserveSize) {
 		size_t tid = tinfo->id;
-		auto *ptr = static_cast<EventQueueBase*>(oak_allocator.allocate(sizeof(EventQueueBase)));
-		new (ptr) EventQueueBase{ tinfo };
+		oak_assert(tid < config::MAX_EVENTS);
+		auto *ptr = static_cast<EventQueueBase*>(oalloc_tagged(MemoryTag::EVENTS)->allocate(sizeof(EventQueueBase)));
+		new (ptr) EventQueueBase{ tinfo, doubleBuffered, reserveSize };
+		doubleBuffered_[tid] = doubleBuffered;
 		if (queues_.size() <= tid) {
 			queues_.resize(tid + 1);
 		}
@@ -40,9 +42,27 @@ namespace oak {
 		return *queues_[tid];
 	}
 
+	void EventManager::flush() {
+		for (auto& queue : queues_) {
+			if (queue != nullptr) {
+				queue->flush();
+			}
+		}
+	}
+
+	void EventManager::flush(const std::bitset<config::MAX_EVENTS>& events) {
+		for (size_t i = 0; i < queues_.size(); i++) {
+			if (events[i] && queues_[i] != nullptr) {
+				queues_[i]->flush();
+			}
+		}
+	}
+
 	void EventManager::clear() {
 		for (auto& queue : queues_) {
-			queue->clear();
+			if (queue != nullptr) {
+				queue->swap();
+			}
 		}
 	}
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mutex>
+#include <bitset>
 
 #include "oak_assert.h"
 
@@ -25,12 +26,21 @@ namespace oak {
 
 		void init();
 
-		void addQueue(const TypeInfo *tinfo);
+		//events in a double buffered queue can be read the frame after they are emitted
+		void addQueue(const TypeInfo *tinfo, bool doubleBuffered = false, size_t reserveSize = config::EVENT_RESERVE_SIZE);
 		EventQueueBase& getQueue(const TypeInfo *tinfo);
 
+		//moves events emitted from worker threads into their queues
+		void flush();
+		void flush(const std::bitset<config::MAX_EVENTS>& events);
+		//ends the frame, single buffered queues are cleared and double buffered queues are swapped
 		void clear();
+
+		//event types whose producers and consumers never touch the same events
+		inline const std::bitset<config::MAX_EVENTS>& getDoubleBuffered() const { return doubleBuffered_; }
 	private:
 		oak::vector<EventQueueBase*> queues_;
+		std::bitset<config::MAX_EVENTS> doubleBuffered_;
 	};
 
 }
@@ -1,23 +1,111 @@
 #include "event_queue.h"
 
+#include <utility>
+
+#include "oak_alloc.h"
+
 namespace oak {
 
-	EventQueueBase::EventQueueBase(const TypeInfo *tinfo) :
+	EventBuffer::EventBuffer(size_t eventSize, size_t reserveSize) : 
+		eventSize_{ eventSize }, 
+		arena_{ reserveSize, 64_kb, 4_mb, 16, MemoryTag::EVENTS } {}
+
+	void* EventBuffer::next() {
+		arena_.allocate(eventSize_);
+		return at(size_++);
+	}
+
+	size_t EventBuffer::nextN(size_t count) {
+		const size_t first = size_;
+		arena_.allocate(eventSize_ * count);
+		size_ += count;
+		return first;
+	}
+
+	void EventBuffer::clear() {
+		//committed pages are kept for the next frame
+		size_ = 0;
+		arena_.clear();
+	}
+
+	EventQueueBase::EventQueueBase(const TypeInfo *tinfo, bool doubleBuffered, size_t reserveSize) :
+		typeInfo{ tinfo },
 		alignedSize{ ptrutil::alignSize(tinfo->size, 16) },
-		size{ 0 },
-		allocator{ &oalloc_freelist, 256 * alignedSize, 16 } {}
+		buffers_{ { alignedSize, reserveSize }, { alignedSize, reserveSize } },
+		read_{ &buffers_[0] },
+		write_{ doubleBuffered ? &buffers_[1] : &buffers_[0] },
+		reserveSize_{ reserveSize },
+		owner_{ util::threadSlot() },
+		staging_{} {}
+
+	EventQueueBase::~EventQueueBase() {
+		for (auto stage : staging_) {
+			if (stage != nullptr) {
+				stage->~EventBuffer();
+				oalloc_tagged(MemoryTag::EVENTS)->deallocate(stage, sizeof(EventBuffer));
+			}
+		}
+	}
 
 	void EventQueueBase::clear() {
-		allocator.clear();
-		size = 0;
+		read_->clear();
+		write_->clear();
+		for (auto stage : staging_) {
+			if (stage != nullptr) {
+				stage->clear();
+			}
+		}
+	}
+
+	void EventQueueBase::swap() {
+		if (!isDoubleBuffered()) {
+			clear();
+			return;
+		}
+		//events still staged on other threads belong to the frame that just ended
+		flush();
+		read_->clear();
+		std::swap(read_, write_);
+	}
+
+	bool EventQueueBase::empty() const {
+		return read_->size() == 0;
 	}
 
-	bool EventQueueBase::empty() {
-		return size == 0;
+	size_t EventQueueBase::size() const {
+		return read_->size();
 	}
 
 	void* EventQueueBase::next() {
-		size++;
-		return allocator.allocate(alignedSize);
+		return getBuffer().next();
 	}
+
+	EventBuffer& EventQueueBase::getBuffer() {
+		const size_t slot = util::threadSlot();
+		if (slot == owner_) {
+			return *write_;
+		}
+		//only the thread that owns the slot touches its staging buffer until the next flush
+		auto& stage = staging_[slot];
+		if (stage == nullptr) {
+			stage = static_cast<EventBuffer*>(oalloc_tagged(MemoryTag::EVENTS)->allocate(sizeof(EventBuffer)));
+			new (stage) EventBuffer{ alignedSize, reserveSize_ };
+		}
+		return *stage;
+	}
+
+	void EventQueueBase::flush() {
+		for (auto stage : staging_) {
+			if (stage == nullptr || stage->size() == 0) { continue; }
+			const size_t count = stage->size();
+			const size_t first = write_->nextN(count);
+			for (size_t i = 0; i < count; i++) {
+				void *src = stage->at(i);
+				typeInfo->moveConstruct(write_->at(first + i), src);
+				typeInfo->destruct(src);
+			}
+			stage->clear();
+		}
+	}
+
 }
@@ -3,26 +3,86 @@
 #include <iterator>
 
 #include "util/ptr_util.h"
+#include "util/thread_id.h"
 #include "type_info.h"
-#include "allocators.h"
+#include "container.h"
 
 namespace oak {
 
+	namespace config {
+		constexpr size_t EVENT_RESERVE_SIZE = size_t{ 1 } << 26; //default address space reserved for each event buffer of a queue
+	}
+
+	//contiguous array of type erased events, events never move once they are added
+	//the storage is a virtual arena so growing the buffer never copies or relinks events
+	class EventBuffer {
+	public:
+		EventBuffer(size_t eventSize, size_t reserveSize = config::EVENT_RESERVE_SIZE);
+
+		EventBuffer(const EventBuffer&) = delete;
+		void operator=(const EventBuffer&) = delete;
+
+		void* next();
+		//adds count consecutive events and returns the index of the first one
+		size_t nextN(size_t count);
+		void clear();
+
+		inline void* at(size_t index) { return ptrutil::add(arena_.getStart(), index * eventSize_); }
+		inline const void* at(size_t index) const { return ptrutil::add(arena_.getStart(), index * eventSize_); }
+		inline const void* data() const { return arena_.getStart(); }
+
+		inline size_t size() const { return size_; }
+
+	private:
+		size_t eventSize_;
+		size_t size_ = 0;
+		VirtualArena arena_;
+	};
+
+	//a double buffered queue is written to during a frame while the events from the previous frame are read,
+	//the buffers are swapped at the end of the frame so producers and consumers never touch the same events
 	struct EventQueueBase {
-		EventQueueBase(const TypeInfo *tinfo); 
+		//each of the queues buffers, including the staging buffer of every thread that emits into it, reserves reserveSize bytes
+		EventQueueBase(const TypeInfo *tinfo, bool doubleBuffered = false, size_t reserveSize = config::EVENT_RESERVE_SIZE); 
+		~EventQueueBase();
 
+		//discards every event
 		void clear();
-		bool empty();
+		//called at the end of a frame, single buffered queues are cleared and
+		//double buffered queues discard the events that were read and make the new events readable
+		void swap();
+		bool empty() const;
+		size_t size() const;
+		inline bool isDoubleBuffered() const { return read_ != write_; }
+		//any thread may add events, events from threads other than the one that created the queue
+		//are staged per thread and only become visible after flush
 		void* next();
-
-		size_t alignedSize, size;
-		LinearAllocator allocator;
+		//buffer that events emitted from the calling thread are written to
+		EventBuffer& getBuffer();
+		//appends the staged events to the queue, no thread may be emitting while the queue is flushed
+		void flush();
+
+		inline void* operator[](size_t index) { return read_->at(index); }
+		inline const void* operator[](size_t index) const { return read_->at(index); }
+
+		const TypeInfo *typeInfo;
+		size_t alignedSize;
+
+	protected:
+		EventBuffer buffers_[2];
+		//events are read from read_ and emitted into write_, they are the same buffer unless the queue is double buffered
+		EventBuffer *read_, *write_;
+
+	private:
+		size_t reserveSize_;
+		size_t owner_;
+		EventBuffer *staging_[config::MAX_THREAD_SLOTS];
 	};
 
 	template<class T>
 	struct EventQueue: public EventQueueBase {
 
-		EventQueue() : EventQueueBase(&T::typeInfo) {}
+		EventQueue(bool doubleBuffered = false, size_t reserveSize = config::EVENT_RESERVE_SIZE) : EventQueueBase(&T::typeInfo, doubleBuffered, reserveSize) {}
 
 		template<class... TArgs>
 		void emit(TArgs&&... args) {
@@ -30,43 +90,68 @@ namespace oak {
 			new (ptr) T{ std::forward<TArgs>(args)... };
 		}
 
-		class const_iterator : public std::iterator<std::forward_iterator_tag, T> {
+		//emits count copies of event
+		void emitN(size_t count, const T& event) {
+			auto& buffer = getBuffer();
+			const size_t first = buffer.nextN(count);
+			for (size_t i = 0; i < count; i++) {
+				new (buffer.at(first + i)) T{ event };
+			}
+		}
+
+		void emitN(const T *events, size_t count) {
+			auto& buffer = getBuffer();
+			const size_t first = buffer.nextN(count);
+			for (size_t i = 0; i < count; i++) {
+				new (buffer.at(first + i)) T{ events[i] };
+			}
+		}
+
+		class const_iterator {
 		public:
-			static constexpr size_t ALIGNED_SIZE = ptrutil::alignSize(detail::size_of_void<T>::value, 16);
-
-			explicit const_iterator(const detail::Block *header, size_t count = 0) :
-			header_{ header },
-			ptr_{ static_cast<const T*>(ptrutil::add(header_, sizeof(detail::Block))) },
-			count_{ count - 1 },
-			left_{ 256 } {}
-
-			const_iterator& operator++() {
-				count_--;
-				left_--;
-				ptr_ = static_cast<const T*>(ptrutil::add(ptr_, ALIGNED_SIZE));
-				if (left_ > 0) {
-					return *this;
-				} else {
-					header_ = static_cast<const detail::Block*>(header_->next);
-					ptr_ = static_cast<const T*>(ptrutil::add(header_, sizeof(detail::Block)));
-					left_ = 256;
-					return *this;
-				}
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			const_iterator() = default;
+			const_iterator(const EventBuffer *buffer, size_t index) : buffer_{ buffer }, index_{ index } {}
+
+			reference operator*() const { return *static_cast<const T*>(buffer_->at(index_)); }
+			pointer operator->() const { return static_cast<const T*>(buffer_->at(index_)); }
+			reference operator[](difference_type n) const { return *static_cast<const T*>(buffer_->at(index_ + n)); }
+
+			const_iterator& operator++() { index_++; return *this; }
+			const_iterator& operator--() { index_--; return *this; }
+			const_iterator operator++(int) { auto it = *this; index_++; return it; }
+			const_iterator operator--(int) { auto it = *this; index_--; return it; }
+			const_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+			const_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+			friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+			friend const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+			friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+			friend difference_type operator-(const const_iterator& a, const const_iterator& b) {
+				return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
 			}
 
-			bool operator==(const const_iterator& other) const { return count_ == other.count_; }
-			bool operator!=(const const_iterator& other) const { return !operator==(other); }
+			bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+			bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+			bool operator<(const const_iterator& other) const { return index_ < other.index_; }
+			bool operator>(const const_iterator& other) const { return index_ > other.index_; }
+			bool operator<=(const const_iterator& other) const { return index_ <= other.index_; }
+			bool operator>=(const const_iterator& other) const { return index_ >= other.index_; }
 
-			const T& operator*() const { return *ptr_; }
 		private:
-			const detail::Block *header_;
-			const T *ptr_;
-			size_t count_, left_;
+			const EventBuffer *buffer_ = nullptr;
+			size_t index_ = 0;
 		};
 
+		const_iterator begin() const { return const_iterator{ read_, 0 }; }
+		const_iterator end() const { return const_iterator{ read_, read_->size() }; }
 
-		const_iterator begin() { return const_iterator{ static_cast<const detail::Block*>(allocator.getStart()), size }; }
-		const_iterator end() { return const_iterator{ nullptr, 0 }; }
+		inline const T& operator[](size_t index) const { return *static_cast<const T*>(read_->at(index)); }
 
 	};
 
@@ -41,8 +41,10 @@ namespace fs = std::experimental::filesystem;
 			}
 		}
 
-		oak::string delimeters{ "/" };
-		oak::vector<oak::string> tokens;
+		//the tokens only live for the call, the resolved path is built from a link so it uses the default allocator
+		ScopedArena scratch;
+		oak::string delimeters{ "/", scratch.allocator<char>() };
+		oak::vector<oak::string> tokens{ scratch.allocator<oak::string>() };
 
 		util::splitstr(mountPoint, delimeters, tokens);
 
@@ -65,11 +67,14 @@ namespace fs = std::experimental::filesystem;
 		}
 		//once we have found the appropriate virtual fs node then we add the path to its links vector
 		dir->links.push_back(resolvedPath);
+		mountPaths_.push_back(resolvedPath);
 	}
 
 	oak::string FileManager::resolvePath(const oak::string& path, bool canCreate) {
-		oak::string delimeters{ "/" };
-		oak::vector<oak::string> tokens;
+		//the tokens only live for the call, the resolved path is built from a link so it uses the default allocator
+		ScopedArena scratch;
+		oak::string delimeters{ "/", scratch.allocator<char>() };
+		oak::vector<oak::string> tokens{ scratch.allocator<oak::string>() };
 
 		util::splitstr(path, delimeters, tokens);
 
@@ -93,7 +98,7 @@ namespace fs = std::experimental::filesystem;
 		//we now have the virtual directory so try to resolve the path with all of its links
 
 		//first reconstruct the path namst reconstruct the path name
-		oak::string pathSuffix;
+		oak::string pathSuffix{ scratch.allocator<char>() };
 
 		for (; it != end; ++it) {
 			pathSuffix += "/" + *it;
@@ -136,4 +141,36 @@ namespace fs = std::experimental::filesystem;
 		stream.buffer = nullptr;
 	}
 
+	MappedBuffer FileManager::mapFile(const oak::string& path) {
+		const oak::string resolvedPath = resolvePath(path);
+		MappedBuffer buffer{ resolvedPath.c_str() };
+
+		if (!buffer.isValid()) {
+			log_print_err("failed to map file: %s", path.c_str());
+			abort();
+		}
+
+		return buffer;
+	}
+
+	oak::vector<char> FileManager::readFile(const oak::string& path) {
+		const oak::string resolvedPath = resolvePath(path);
+		oak::vector<char> data;
+		FILE *file = fopen(resolvedPath.c_str(), "rb");
+		if (!file) {
+			log_print_warn("failed to read file: %s", path.c_str());
+			return data;
+		}
+
+		//read until the end instead of trusting the size up front, the file can change while it is read
+		char buffer[4096];
+		size_t count;
+		while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+			data.insert(std::end(data), buffer, buffer + count);
+		}
+		fclose(file);
+
+		return data;
+	}
+
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "oak_assert.h"
 #include "util/stream.h"
+#include "util/mapped_buffer.h"
 #include "container.h"
 
 namespace oak {
@@ -33,8 +34,17 @@ namespace oak {
 
 		Stream openFile(const oak::string& path, bool canCreate = false);
 		void closeFile(Stream& stream);
+		//maps a file read only, the contents can be parsed in place and are unmapped with the buffer
+		MappedBuffer mapFile(const oak::string& path);
+		//reads a private copy of a file, unlike a mapping the copy is not affected when the file is truncated or rewritten
+		//while it is parsed (eg. decoding a resource that is being hot reloaded), returns an empty buffer if it cannot be read
+		oak::vector<char> readFile(const oak::string& path);
+
+		//the real directories that have been mounted, in mount order
+		inline const oak::vector<oak::string>& getMountPaths() const { return mountPaths_; }
 	private:
 		VirtualDirectory root_;
+		oak::vector<oak::string> mountPaths_;
 	};
 
 }
\ No newline at end of file
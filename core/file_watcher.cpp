@@ -0,0 +1,93 @@
+#include "file_watcher.h"
+
+#include <algorithm>
+#include <experimental/filesystem>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "log.h"
+
+namespace oak {
+namespace fs = std::experimental::filesystem;
+
+#ifdef __linux__
+	namespace {
+		constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+	}
+
+	FileWatcher::FileWatcher() {
+		fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd_ < 0) {
+			log_print_warn("failed to create file watcher");
+		}
+	}
+
+	FileWatcher::~FileWatcher() {
+		if (fd_ >= 0) {
+			close(fd_);
+		}
+	}
+
+	void FileWatcher::watch(const oak::string& path) {
+		if (fd_ < 0) { return; }
+		std::error_code error;
+		if (!fs::is_directory(path.c_str(), error)) { return; }
+		addWatch(path);
+		for (fs::recursive_directory_iterator it{ path.c_str(), error }, end; it != end; it.increment(error)) {
+			if (fs::is_directory(it->status())) {
+				addWatch(it->path().c_str());
+			}
+		}
+	}
+
+	void FileWatcher::poll(oak::vector<oak::string>& changed) {
+		if (fd_ < 0) { return; }
+		alignas(inotify_event) char buffer[4096];
+		const size_t first = changed.size();
+		while (true) {
+			ssize_t size = read(fd_, buffer, sizeof(buffer));
+			if (size <= 0) { break; }
+			for (char *ptr = buffer; ptr < buffer + size;) {
+				auto event = reinterpret_cast<inotify_event*>(ptr);
+				ptr += sizeof(inotify_event) + event->len;
+
+				auto it = directories_.find(event->wd);
+				if (it == std::end(directories_) || event->len == 0) { continue; }
+				oak::string path = it->second + "/" + event->name;
+
+				if (event->mask & IN_ISDIR) {
+					if (event->mask & IN_CREATE) {
+						watch(path);
+					}
+				} else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+					//editors that save through a temporary file show up as moves
+					if (std::find(std::begin(changed) + first, std::end(changed), path) == std::end(changed)) {
+						changed.push_back(std::move(path));
+					}
+				}
+			}
+		}
+	}
+
+	void FileWatcher::addWatch(const oak::string& path) {
+		int wd = inotify_add_watch(fd_, path.c_str(), WATCH_MASK);
+		if (wd < 0) {
+			log_print_warn("failed to watch directory: %s", path.c_str());
+			return;
+		}
+		//changes are reported with canonical paths so a directory reached through two mounts or a link has one name
+		std::error_code error;
+		auto canonical = fs::canonical(path.c_str(), error);
+		directories_.insert({ wd, error ? path : oak::string{ canonical.c_str() } });
+	}
+#else
+	FileWatcher::FileWatcher() {}
+	FileWatcher::~FileWatcher() {}
+	void FileWatcher::watch(const oak::string& path) {}
+	void FileWatcher::poll(oak::vector<oak::string>& changed) {}
+	void FileWatcher::addWatch(const oak::string& path) {}
+#endif
+
+}
\ No newline at end of file
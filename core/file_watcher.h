@@ -0,0 +1,30 @@
+#pragma once
+
+#include "container.h"
+
+namespace oak {
+
+	//reports files that were written to in the watched directories, uses inotify on linux and does nothing elsewhere
+	class FileWatcher {
+	public:
+		FileWatcher();
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		void operator=(const FileWatcher&) = delete;
+
+		//watches the directory and every directory below it, directories created later are watched as they appear
+		void watch(const oak::string& path);
+		//appends the canonical paths of the files that changed since the last poll, never blocks
+		void poll(oak::vector<oak::string>& changed);
+
+		inline size_t getDirectoryCount() const { return directories_.size(); }
+	private:
+		int fd_ = -1;
+		//watch descriptor to canonical directory path
+		oak::hash_map<int, oak::string> directories_;
+
+		void addWatch(const oak::string& path);
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+#include "oak_alloc.h"
+
+namespace oak {
+
+	//multiple producer single consumer channel for handing frame lifetime data between threads
+	//values are allocated from the sending threads frame arena and published with release ordering,
+	//the channel must be drained before the frame allocator is cleared
+	template<class T>
+	class FrameChannel {
+	public:
+		FrameChannel(FrameAllocator *allocator = &oalloc_frame) : allocator_{ allocator }, head_{ nullptr } {}
+
+		FrameChannel(const FrameChannel&) = delete;
+		void operator=(const FrameChannel&) = delete;
+
+		template<class... TArgs>
+		void send(TArgs&&... args) {
+			static_assert(alignof(Node) <= 8, "frame channel values must not need more than 8 byte alignment");
+			auto node = static_cast<Node*>(allocator_->allocate(sizeof(Node)));
+			new (node) Node{ nullptr, T{ std::forward<TArgs>(args)... } };
+			Node *head = head_.load(std::memory_order_relaxed);
+			do {
+				node->next = head;
+			} while (!head_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		//calls func(value) for every value sent since the last receive, values from one thread arrive in the order they were sent
+		//only one thread may receive at a time
+		template<class F>
+		void receive(F&& func) {
+			Node *node = head_.exchange(nullptr, std::memory_order_acquire);
+			//the list is newest first so reverse it
+			Node *prev = nullptr;
+			while (node != nullptr) {
+				Node *next = node->next;
+				node->next = prev;
+				prev = node;
+				node = next;
+			}
+			while (prev != nullptr) {
+				Node *next = prev->next;
+				func(prev->value);
+				prev->value.~T();
+				prev = next;
+			}
+		}
+
+		inline bool empty() const { return head_.load(std::memory_order_acquire) == nullptr; }
+
+	private:
+		struct Node {
+			Node *next;
+			T value;
+		};
+
+		FrameAllocator *allocator_;
+		std::atomic<Node*> head_;
+	};
+
+}
@@ -21,5 +21,6 @@ namespace oak::graphics {
 
 	void pup(Puper& puper, Font& data, const ObjInfo& info);
 	
+	//only reads and parses the glyph file, so it can be the decode step of a ResourceLoader load
 	Font loadFont(const oak::string& path);
 }
@@ -9,11 +9,12 @@
 namespace oak::graphics::GLShader {
 
 	static GLuint load(const char *path, GLenum type);
+	static GLuint compile(const char *source, size_t size, const char *path, GLenum type);
+	static uint32_t link(const oak::vector<GLuint>& shaders);
 
 	Shader create(const ShaderInfo& info) {
 
 		//create the program
-		uint32_t pid = glCreateProgram();
 		oak::vector<GLuint> shaders;
 		if (info.vertex) {
 			shaders.push_back(load(info.vertex, GL_VERTEX_SHADER));
@@ -24,16 +25,8 @@ namespace oak::graphics::GLShader {
 		if (info.fragment) {
 			shaders.push_back(load(info.fragment, GL_FRAGMENT_SHADER));
 		}
-		for (auto id : shaders) {
-			glAttachShader(pid, id);
-		}
-		glLinkProgram(pid);
-		glValidateProgram(pid);
-		for (auto id : shaders) {
-			glDeleteShader(id);
-		}
 
-		return { pid, info };
+		return { link(shaders), info };
 
 		/*
 		//get all the uniform names
@@ -65,6 +58,36 @@ namespace oak::graphics::GLShader {
 		*/
 	}
 
+	ShaderSource decode(const ShaderInfo& info) {
+		//the sources are copied instead of mapped, a reload reads the files while they can still be rewritten
+		ShaderSource source;
+		if (info.vertex) {
+			source.vertex = FileManager::inst().readFile(info.vertex);
+		}
+		if (info.geometry) {
+			source.geometry = FileManager::inst().readFile(info.geometry);
+		}
+		if (info.fragment) {
+			source.fragment = FileManager::inst().readFile(info.fragment);
+		}
+		return source;
+	}
+
+	Shader create(const ShaderSource& source, const ShaderInfo& info) {
+		oak::vector<GLuint> shaders;
+		if (info.vertex) {
+			shaders.push_back(compile(source.vertex.data(), source.vertex.size(), info.vertex, GL_VERTEX_SHADER));
+		}
+		if (info.geometry) {
+			shaders.push_back(compile(source.geometry.data(), source.geometry.size(), info.geometry, GL_GEOMETRY_SHADER));
+		}
+		if (info.fragment) {
+			shaders.push_back(compile(source.fragment.data(), source.fragment.size(), info.fragment, GL_FRAGMENT_SHADER));
+		}
+
+		return { link(shaders), info };
+	}
+
 	void destroy(Shader& shader) {
 		if (shader.id) {
 			glDeleteProgram(shader.id);
@@ -113,14 +136,35 @@ namespace oak::graphics::GLShader {
 		glUniform1f(glGetUniformLocation(shader.id, name), value);
 	}
 
+	uint32_t link(const oak::vector<GLuint>& shaders) {
+		uint32_t pid = glCreateProgram();
+		for (auto id : shaders) {
+			glAttachShader(pid, id);
+		}
+		glLinkProgram(pid);
+		glValidateProgram(pid);
+		for (auto id : shaders) {
+			glDeleteShader(id);
+		}
+		return pid;
+	}
+
 	GLuint load(const char *path, GLenum type) {
-		auto file = FileManager::inst().openFile(path);
-		const oak::string code = file.read<oak::string>();
-		FileManager::inst().closeFile(file);
-		const char *cstr = code.c_str();
+		//the source is handed to gl straight from the mapped file
+		auto file = FileManager::inst().mapFile(path);
+		return compile(file.data(), file.size(), path, type);
+	}
+
+	GLuint compile(const char *source, size_t size, const char *path, GLenum type) {
+		//empty files have no data, gl still gets a valid (empty) source so the failure is logged below
+		if (size == 0) {
+			log_print_warn("empty shader file: %s", path);
+		}
+		const char *cstr = size > 0 ? source : "";
+		GLint sourceLength = static_cast<GLint>(size);
 
 		GLuint shader = glCreateShader(type);
-		glShaderSource(shader, 1, &cstr, NULL);
+		glShaderSource(shader, 1, &cstr, &sourceLength);
 		glCompileShader(shader);
 
 		//get and print results of compiliation
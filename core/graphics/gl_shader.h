@@ -5,11 +5,15 @@
 namespace oak::graphics {
 	struct Shader;
 	struct ShaderInfo;
+	struct ShaderSource;
 }
 
 namespace oak::graphics::GLShader {
 
 	Shader create(const ShaderInfo& info);
+	//create split in two, decode reads the stage files on any thread and create compiles them
+	ShaderSource decode(const ShaderInfo& info);
+	Shader create(const ShaderSource& source, const ShaderInfo& info);
 	void destroy(Shader& shader);
 
 	void bind(const Shader& shader);
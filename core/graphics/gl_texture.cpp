@@ -61,36 +61,66 @@ namespace oak::graphics::GLTexture {
 		GL_CLAMP_TO_EDGE
 	};
 
+	//decodes straight from the mapped file instead of reading it through stdio
+	static stbi_uc* loadImage(const char *path, int *w, int *h, int *comp, int rcomp) {
+		MappedBuffer file{ FileManager::inst().resolvePath(path).c_str() };
+		if (!file.isValid() || file.size() == 0) { return nullptr; }
+		return stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), static_cast<int>(file.size()), w, h, comp, rcomp);
+	}
+
+	//decode runs on loader threads while a hot reloaded file can still be rewritten, a mapping of a file
+	//that is truncated faults the reading thread so the decode steps read a copy of the file instead
+	static stbi_uc* readImage(const char *path, int *w, int *h, int *comp, int rcomp) {
+		auto file = FileManager::inst().readFile(path);
+		if (file.empty()) { return nullptr; }
+		return stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), static_cast<int>(file.size()), w, h, comp, rcomp);
+	}
+
 	void bind(const Texture& texture, int slot) {
 		glActiveTexture(GL_TEXTURE0 + slot);
 		glBindTexture(types[static_cast<int>(texture.info.type)], texture.id);
 	}
 
 	Texture create(const char *path, const TextureInfo& info) {
+		return create(decode(path, info), info);
+	}
+
+	Image decode(const char *path, const TextureInfo& info) {
 		int w, h, comp;
-		stbi_uc *data = stbi_load(FileManager::inst().resolvePath(path).c_str(), &w, &h, &comp, components[static_cast<int>(info.format)]);
+		Image image;
+		image.pixels = readImage(path, &w, &h, &comp, components[static_cast<int>(info.format)]);
 
-		if (!data) {
+		if (!image.pixels) {
 			log_print_warn("failed to load texture: %s", path);
+		} else {
+			image.width = w;
+			image.height = h;
 		}
 
+		return image;
+	}
+
+	Texture create(const Image& image, const TextureInfo& info) {
 		TextureInfo ti = info;
-		ti.width = w;
-		ti.height = h;
+		ti.width = image.width;
+		ti.height = image.height;
 
-		const Texture& tex = create(ti, data);
+		const Texture& tex = create(ti, image.pixels);
 
 		if (static_cast<int>(info.minFilter) >= static_cast<int>(TextureFilter::LINEAR_MIP_LINEAR)) {
 			glGenerateMipmap(GL_TEXTURE_2D);
 		}
 
-		if (data) {
-			stbi_image_free(data);
-		}
-
 		return tex;
 	}
 
+	void freeImage(Image& image) {
+		if (image.pixels) {
+			stbi_image_free(image.pixels);
+			image.pixels = nullptr;
+		}
+	}
+
 	Texture create(const TextureInfo& info, void *data) {
 
 		const auto& format = formats[static_cast<int>(info.format)];
@@ -121,6 +151,20 @@ namespace oak::graphics::GLTexture {
 	}
 
 	TextureAtlas createAtlas(const oak::vector<const char*>& paths, const TextureInfo& info) {
+		return createAtlas(decodeAtlas(paths, info), paths, info);
+	}
+
+	oak::vector<Image> decodeAtlas(const oak::vector<const char*>& paths, const TextureInfo& info) {
+		oak::vector<Image> images;
+		images.reserve(paths.size());
+		for (auto path : paths) {
+			images.push_back(decode(path, info));
+		}
+		return images;
+	}
+
+	TextureAtlas createAtlas(const oak::vector<Image>& images, const oak::vector<const char*>& paths, const TextureInfo& info) {
+		oak_assert(images.size() == paths.size());
 		const auto& format = formats[static_cast<int>(info.format)];
 
 		GLenum type = types[static_cast<int>(info.type)];
@@ -130,37 +174,20 @@ namespace oak::graphics::GLTexture {
 		GLenum xw = wrap[static_cast<int>(info.xWrap)];
 		GLenum yw = wrap[static_cast<int>(info.yWrap)];
 
-		int rcomp = components[static_cast<int>(info.format)];
-
-		struct ImageInfo {
-			const char *name;
-			stbi_uc *data;
-			int width, height, comp;
-		};
-
-		oak::vector<ImageInfo> images;
-
-		//load textures
-		for (auto path : paths) {
-			int w, h, c;
-			stbi_uc *data = stbi_load(FileManager::inst().resolvePath(path).c_str(), &w, &h, &c, rcomp);
-			if (!data) {
-				log_print_warn("failed to load texture: %s", path);
-			}
-			images.push_back({ path, data, w, h, c});
-		}
+		//packing data is only needed while the atlas is built
+		ScopedArena scratch;
 
 		TextureAtlas atlas;
 		atlas.regions.resize(images.size());
 
 		//pack rects
-		oak::vector<stbrp_node> nodes;
+		oak::vector<stbrp_node> nodes{ scratch.allocator<stbrp_node>() };
 		nodes.resize(info.width+1);
 
 		stbrp_context c;
 		stbrp_init_target(&c, info.width, info.height, nodes.data(), nodes.size());
 
-		oak::vector<stbrp_rect> rects;
+		oak::vector<stbrp_rect> rects{ scratch.allocator<stbrp_rect>() };
 		rects.resize(images.size());
 
 		for (size_t i = 0; i < rects.size(); i++) {
@@ -195,12 +222,12 @@ namespace oak::graphics::GLTexture {
 			for (const auto& rect : rects) {
 				const auto& image = images[rect.id];
 				auto& region = atlas.regions[rect.id];
-				region.first = oak::string{ image.name };
+				region.first = oak::string{ paths[rect.id] };
 
 				region.second.pos = { rect.x * tx, rect.y * ty };
 				region.second.extent = { rect.w * ty, rect.h * ty };
 
-				glTexImage2D(type, 0, format[0], image.width, image.height, 0, format[1], format[2], image.data);
+				glTexImage2D(type, 0, format[0], image.width, image.height, 0, format[1], format[2], image.pixels);
 				glGenerateMipmap(type);
 
 				int mipLevels = 1 + floor(log2(std::max(image.width, image.height)));
@@ -214,19 +241,12 @@ namespace oak::graphics::GLTexture {
 			for (const auto& rect : rects) {
 				const auto& image = images[rect.id];
 				auto& region = atlas.regions[rect.id];
-				region.first = oak::string{ image.name };
+				region.first = oak::string{ paths[rect.id] };
 
 				region.second.pos = { rect.x * tx, rect.y * ty };
 				region.second.extent = { rect.w * ty, rect.h * ty };
 
-				glTexSubImage2D(type, 0, rect.x, rect.y, rect.w, rect.h, format[1], format[2], image.data);
-			}
-		}
-		
-		//free image data
-		for (auto& image : images) {
-			if (image.data) {
-				stbi_image_free(image.data);
+				glTexSubImage2D(type, 0, rect.x, rect.y, rect.w, rect.h, format[1], format[2], image.pixels);
 			}
 		}
 
@@ -261,7 +281,7 @@ namespace oak::graphics::GLTexture {
 		int w, h, comp, i = 0;
 		stbi_uc *data;
 		for (auto path : paths) {
-			data = stbi_load(FileManager::inst().resolvePath(path).c_str(), &w, &h, &comp, rcomp);
+			data = loadImage(path, &w, &h, &comp, rcomp);
 
 			if (data == nullptr) {
 				log_print_warn("failed to load texture: %s", path);
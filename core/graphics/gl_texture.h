@@ -6,6 +6,7 @@ namespace oak::graphics {
 	struct Texture;
 	struct TextureInfo;
 	struct TextureAtlas;
+	struct Image;
 }
 
 namespace oak::graphics::GLTexture {
@@ -15,8 +16,15 @@ namespace oak::graphics::GLTexture {
 
 	Texture create(const char *path, const TextureInfo& info);
 	Texture create(const TextureInfo& info, void *data);
+	//create split in two, decode can be called from any thread and create uploads the image
+	Image decode(const char *path, const TextureInfo& info);
+	Texture create(const Image& image, const TextureInfo& info);
+	void freeImage(Image& image);
 
 	TextureAtlas createAtlas(const oak::vector<const char*>& paths, const TextureInfo& info);
+	//createAtlas split in two, the images are decoded in path order and the regions are named after the paths
+	oak::vector<Image> decodeAtlas(const oak::vector<const char*>& paths, const TextureInfo& info);
+	TextureAtlas createAtlas(const oak::vector<Image>& images, const oak::vector<const char*>& paths, const TextureInfo& info);
 	Texture createCubemap(const oak::vector<const char*>& paths, const TextureInfo& info);
 	
 	void destroy(Texture& texture);
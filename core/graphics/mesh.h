@@ -21,6 +21,7 @@ namespace oak::graphics {
 		oak::vector<uint32_t> indices;
 	};
 
+	//only reads the file and does not use the graphics api, so it can be the decode step of a ResourceLoader load
 	oak::vector<Mesh> loadModel(const oak::string& path);
 
 	void pup(Puper& puper, Mesh& data, const ObjInfo& info);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cinttypes>
+#include "container.h"
 #include "resource.h"
 
 namespace oak::graphics {
@@ -12,6 +13,13 @@ namespace oak::graphics {
 		const char *tessellation = nullptr;
 	};
 
+	//stage sources read from the files of a shader, reading does not use the graphics api so it can run on a loader thread
+	struct ShaderSource {
+		oak::vector<char> vertex;
+		oak::vector<char> fragment;
+		oak::vector<char> geometry;
+	};
+
 	struct Shader {
 		static const TypeInfo typeInfo;
 
@@ -42,8 +42,8 @@ namespace oak::graphics {
 			}
 		};
 
-		oak::vector<SpriteInfo> sprites_;
-		oak::vector<Batch> batches_;
+		oak::vector<SpriteInfo> sprites_{ OakAllocator<SpriteInfo>{ oalloc_tagged(MemoryTag::GRAPHICS) } };
+		oak::vector<Batch> batches_{ OakAllocator<Batch>{ oalloc_tagged(MemoryTag::GRAPHICS) } };
 	};
 
 }
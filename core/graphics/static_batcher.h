@@ -45,8 +45,8 @@ namespace oak::graphics {
 			}
 		};
 
-		oak::vector<MeshInfo> meshes_;
-		oak::vector<Batch> batches_;
+		oak::vector<MeshInfo> meshes_{ OakAllocator<MeshInfo>{ oalloc_tagged(MemoryTag::GRAPHICS) } };
+		oak::vector<Batch> batches_{ OakAllocator<Batch>{ oalloc_tagged(MemoryTag::GRAPHICS) } };
 
 		bool needsRebatch_;
 	};
@@ -10,6 +10,24 @@ namespace oak::graphics {
 	void pup(Puper& puper, Texture& data, const ObjInfo& info) {}
 	void pup(Puper& puper, TextureAtlas& data, const ObjInfo& info) {}
 
+	Image::~Image() {
+		texture::freeImage(*this);
+	}
+
+	Image::Image(Image&& other) {
+		*this = std::move(other);
+	}
+
+	void Image::operator=(Image&& other) {
+		texture::freeImage(*this);
+		width = other.width;
+		height = other.height;
+		pixels = other.pixels;
+		other.width = 0;
+		other.height = 0;
+		other.pixels = nullptr;
+	}
+
 	void Texture::destroy() {
 		texture::destroy(*this);
 	}
@@ -29,6 +29,21 @@ namespace oak::graphics {
 		int mipLevels = 1;
 	};
 
+	//pixels decoded from an image file, decoding does not use the graphics api so it can run on a loader thread
+	struct Image {
+		Image() = default;
+		~Image();
+
+		Image(const Image&) = delete;
+		void operator=(const Image&) = delete;
+
+		Image(Image&& other);
+		void operator=(Image&& other);
+
+		uint32_t width = 0, height = 0;
+		void *pixels = nullptr;
+	};
+
 	struct Texture {
 		static const TypeInfo typeInfo;
 
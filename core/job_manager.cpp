@@ -0,0 +1,222 @@
+#include "job_manager.h"
+
+namespace oak {
+
+	JobManager *JobManager::instance = nullptr;
+
+	static thread_local size_t currentThreadIndex = JobManager::INVALID_THREAD;
+
+	size_t JobManager::threadIndex() {
+		return currentThreadIndex;
+	}
+
+	void JobManager::WorkQueue::push(Job *job) {
+		std::lock_guard<std::mutex> lock{ mutex };
+		oak_assert(bottom - top < config::MAX_JOBS);
+		jobs[bottom & (config::MAX_JOBS - 1)] = job;
+		bottom++;
+	}
+
+	Job* JobManager::WorkQueue::pop() {
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (bottom == top) { return nullptr; }
+		bottom--;
+		return jobs[bottom & (config::MAX_JOBS - 1)];
+	}
+
+	Job* JobManager::WorkQueue::steal() {
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (bottom == top) { return nullptr; }
+		Job *job = jobs[top & (config::MAX_JOBS - 1)];
+		top++;
+		return job;
+	}
+
+	JobManager::JobManager(size_t threadCount) : threadCount_{ threadCount }, running_{ true }, pendingJobs_{ 0 } {
+		oak_assert(instance == nullptr);
+		instance = this;
+
+		if (threadCount_ == 0) { threadCount_ = 1; }
+		if (threadCount_ > config::MAX_JOB_THREADS) { threadCount_ = config::MAX_JOB_THREADS; }
+
+		//allocate the per thread job queues and job pools
+		queues_ = static_cast<WorkQueue*>(oak_allocator.allocate(sizeof(WorkQueue) * threadCount_));
+		pools_ = static_cast<JobPool*>(oak_allocator.allocate(sizeof(JobPool) * threadCount_));
+		for (size_t i = 0; i < threadCount_; i++) {
+			new (&queues_[i]) WorkQueue{};
+			queues_[i].jobs = static_cast<Job**>(oak_allocator.allocate(sizeof(Job*) * config::MAX_JOBS));
+			new (&pools_[i]) JobPool{};
+			pools_[i].jobs = static_cast<Job*>(oak_allocator.allocate(sizeof(Job) * config::MAX_JOBS));
+			for (size_t j = 0; j < config::MAX_JOBS; j++) {
+				new (&pools_[i].jobs[j]) Job{};
+			}
+		}
+		mainQueue_.jobs = static_cast<Job**>(oak_allocator.allocate(sizeof(Job*) * config::MAX_JOBS));
+
+		//the calling thread is worker 0
+		currentThreadIndex = 0;
+		for (size_t i = 1; i < threadCount_; i++) {
+			threads_.emplace_back([this, i]() { work(i); });
+		}
+	}
+
+	JobManager::~JobManager() {
+		running_ = false;
+		{
+			std::lock_guard<std::mutex> lock{ sleepMutex_ };
+			sleepCondition_.notify_all();
+		}
+		for (auto& thread : threads_) {
+			thread.join();
+		}
+		threads_.clear();
+
+		for (size_t i = 0; i < threadCount_; i++) {
+			oak_allocator.deallocate(queues_[i].jobs, sizeof(Job*) * config::MAX_JOBS);
+			queues_[i].~WorkQueue();
+			oak_allocator.deallocate(pools_[i].jobs, sizeof(Job) * config::MAX_JOBS);
+			pools_[i].~JobPool();
+		}
+		oak_allocator.deallocate(queues_, sizeof(WorkQueue) * threadCount_);
+		oak_allocator.deallocate(pools_, sizeof(JobPool) * threadCount_);
+		oak_allocator.deallocate(mainQueue_.jobs, sizeof(Job*) * config::MAX_JOBS);
+
+		instance = nullptr;
+	}
+
+	Job* JobManager::create(JobFunction function, Job *parent, uint32_t flags) {
+		//threads that are not workers share the main threads job pool
+		auto& pool = pools_[currentThreadIndex < threadCount_ ? currentThreadIndex : 0];
+		//the pool is a ring, skip over slots whose job is still in use
+		Job *job = nullptr;
+		for (size_t i = 0; job == nullptr; i++) {
+			oak_assert(i < config::MAX_JOBS);
+			Job *slot = &pool.jobs[pool.next.fetch_add(1) & (config::MAX_JOBS - 1)];
+			if (!slot->active.load(std::memory_order_acquire)) {
+				job = slot;
+			}
+		}
+		job->active.store(true, std::memory_order_relaxed);
+		job->function = function;
+		job->parent = parent;
+		job->unfinished = 1;
+		job->dependencies = 1;
+		job->continuationCount = 0;
+		job->flags = flags;
+		if (parent != nullptr) {
+			parent->unfinished++;
+		}
+		return job;
+	}
+
+	void JobManager::addContinuation(Job *job, Job *continuation) {
+		int32_t index = job->continuationCount.fetch_add(1);
+		oak_assert(index < static_cast<int32_t>(config::MAX_JOB_CONTINUATIONS));
+		continuation->dependencies++;
+		job->continuations[index] = continuation;
+	}
+
+	void JobManager::run(Job *job) {
+		//release the dependency held while the job was being built
+		if (--job->dependencies == 0) {
+			push(job);
+		}
+	}
+
+	void JobManager::wait(const Job *job) {
+		while (!isFinished(job)) {
+			Job *next = getJob();
+			if (next != nullptr) {
+				execute(next);
+			} else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobManager::isFinished(const Job *job) const {
+		return job->unfinished.load() <= 0;
+	}
+
+	void JobManager::work(size_t index) {
+		currentThreadIndex = index;
+		while (running_) {
+			Job *job = getJob();
+			if (job != nullptr) {
+				execute(job);
+			} else {
+				std::unique_lock<std::mutex> lock{ sleepMutex_ };
+				sleepCondition_.wait(lock, [this]() {
+					return !running_ || pendingJobs_.load() > 0;
+				});
+			}
+		}
+	}
+
+	void JobManager::push(Job *job) {
+		if (job->flags & Job::MAIN_THREAD) {
+			mainQueue_.push(job);
+		} else {
+			queues_[currentThreadIndex < threadCount_ ? currentThreadIndex : 0].push(job);
+		}
+		pendingJobs_++;
+		//a worker checks the count under the lock before it sleeps, taking the lock here means
+		//it either sees the new job or is already waiting when it is notified
+		{
+			std::lock_guard<std::mutex> lock{ sleepMutex_ };
+		}
+		sleepCondition_.notify_one();
+	}
+
+	Job* JobManager::getJob() {
+		static thread_local uint32_t seed = 2463534242u;
+
+		const size_t index = currentThreadIndex;
+		Job *job = nullptr;
+		if (index == 0) {
+			job = mainQueue_.pop();
+		}
+		if (job == nullptr && index < threadCount_) {
+			job = queues_[index].pop();
+		}
+		if (job == nullptr) {
+			//try to steal from a random queue
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			const size_t start = seed % threadCount_;
+			for (size_t i = 0; i < threadCount_ && job == nullptr; i++) {
+				const size_t victim = (start + i) % threadCount_;
+				if (victim != index) {
+					job = queues_[victim].steal();
+				}
+			}
+		}
+		if (job != nullptr) {
+			pendingJobs_--;
+		}
+		return job;
+	}
+
+	void JobManager::execute(Job *job) {
+		if (job->function != nullptr) {
+			job->function(job);
+		}
+		finish(job);
+	}
+
+	void JobManager::finish(Job *job) {
+		if (--job->unfinished == 0) {
+			if (job->parent != nullptr) {
+				finish(job->parent);
+			}
+			const int32_t count = job->continuationCount.load();
+			for (int32_t i = 0; i < count; i++) {
+				run(job->continuations[i]);
+			}
+			//the slot can be handed out again once nothing above reads it
+			job->active.store(false, std::memory_order_release);
+		}
+	}
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <type_traits>
+
+#include "oak_assert.h"
+#include "container.h"
+
+namespace oak {
+
+	namespace config {
+		constexpr size_t MAX_JOB_THREADS = 32;
+		constexpr size_t MAX_JOBS = 2048; //per thread, must be a power of 2
+		constexpr size_t MAX_JOB_CONTINUATIONS = 15;
+		//parallelFor uses larger chunks rather than creating more jobs than this
+		constexpr size_t MAX_PARALLEL_CHUNKS = 256;
+	}
+
+	struct Job;
+
+	using JobFunction = void (*)(Job *job);
+
+	struct alignas(64) Job {
+		static constexpr uint32_t MAIN_THREAD = 0x01; //job may only be executed by the thread that owns the job manager
+
+		JobFunction function;
+		Job *parent;
+		//number of unfinished jobs (this job and its children)
+		std::atomic<int32_t> unfinished;
+		//number of jobs that must finish before this job can be scheduled (+1 until run is called)
+		std::atomic<int32_t> dependencies;
+		std::atomic<int32_t> continuationCount;
+		//set while the slot holds a job, cleared by the last store of finish so the slot is not reused while
+		//finish still reads the parent and continuations of a job that waiters already see as finished
+		std::atomic<bool> active;
+		uint32_t flags;
+		Job *continuations[config::MAX_JOB_CONTINUATIONS];
+		alignas(16) char data[64];
+	};
+
+	class JobManager {
+	private:
+		static JobManager *instance;
+	public:
+		inline static JobManager& inst() {
+			oak_assert(instance != nullptr);
+			return *instance;
+		}
+
+		static constexpr size_t INVALID_THREAD = ~size_t{ 0 };
+
+		//index of the calling thread, 0 is the thread that created the job manager
+		//threads not owned by the job manager return INVALID_THREAD
+		static size_t threadIndex();
+
+		JobManager(size_t threadCount = std::thread::hardware_concurrency());
+		~JobManager();
+
+		//create a job, the job will not be scheduled until run is called
+		//a job with no function can be used to group child jobs
+		Job* create(JobFunction function, Job *parent = nullptr, uint32_t flags = 0);
+
+		template<class F, class = std::enable_if_t<!std::is_convertible_v<F, JobFunction>>>
+		Job* create(F&& func, Job *parent = nullptr, uint32_t flags = 0) {
+			using T = std::decay_t<F>;
+			static_assert(sizeof(T) <= sizeof(Job::data), "job function is too large");
+			static_assert(alignof(T) <= 16, "job function alignment is too large");
+			Job *job = create([](Job *job) {
+				T *func = reinterpret_cast<T*>(job->data);
+				(*func)();
+				func->~T();
+			}, parent, flags);
+			new (job->data) T{ std::forward<F>(func) };
+			return job;
+		}
+
+		//continuation will not be scheduled until job has finished, must be called before job is run
+		void addContinuation(Job *job, Job *continuation);
+		void run(Job *job);
+		//executes other jobs while waiting for job to finish
+		void wait(const Job *job);
+		bool isFinished(const Job *job) const;
+
+		//splits [0, count) into chunks and calls func(begin, end) for each chunk on the worker threads
+		//chunks are made larger when count / chunkSize is more than config::MAX_PARALLEL_CHUNKS
+		template<class F>
+		void parallelFor(size_t count, size_t chunkSize, F&& func) {
+			if (count == 0) { return; }
+			oak_assert(chunkSize > 0);
+			const size_t minChunkSize = (count + config::MAX_PARALLEL_CHUNKS - 1) / config::MAX_PARALLEL_CHUNKS;
+			if (chunkSize < minChunkSize) { chunkSize = minChunkSize; }
+			Job *root = create(nullptr);
+			for (size_t i = 0; i < count; i += chunkSize) {
+				const size_t end = i + chunkSize < count ? i + chunkSize : count;
+				run(create([&func, i, end]() { func(i, end); }, root));
+			}
+			run(root);
+			wait(root);
+		}
+
+		inline size_t getThreadCount() const { return threadCount_; }
+
+	private:
+		//work stealing queue, the owning thread pushes and pops from the back, other threads steal from the front
+		struct alignas(64) WorkQueue {
+			std::mutex mutex;
+			Job **jobs = nullptr;
+			size_t top = 0, bottom = 0;
+
+			void push(Job *job);
+			Job* pop();
+			Job* steal();
+		};
+
+		struct alignas(64) JobPool {
+			Job *jobs = nullptr;
+			std::atomic<size_t> next{ 0 };
+		};
+
+		size_t threadCount_;
+		oak::vector<std::thread> threads_;
+		WorkQueue *queues_;
+		WorkQueue mainQueue_;
+		JobPool *pools_;
+
+		std::atomic<bool> running_;
+		std::atomic<int32_t> pendingJobs_;
+		std::mutex sleepMutex_;
+		std::condition_variable sleepCondition_;
+
+		void work(size_t index);
+		void push(Job *job);
+		Job* getJob();
+		void execute(Job *job);
+		void finish(Job *job);
+	};
+
+}
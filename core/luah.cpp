@@ -21,7 +21,7 @@ namespace oak {
 		lua_getfield(L, LUA_REGISTRYINDEX, "_oak_systems_");
 		lua_rotate(L, -2, 1);
 		lua_setfield(L, -2, name.c_str());
-		auto ptr = static_cast<LuaSystem*>(oak_allocator.allocate(sizeof(LuaSystem)));
+		auto ptr = static_cast<LuaSystem*>(oalloc_tagged(MemoryTag::LUA)->allocate(sizeof(LuaSystem)));
 		new (ptr) LuaSystem{ L, name };
 		//TODO:: fix leakage
 		SystemManager::inst().addSystem(ptr, std::hash<oak::string>{}(name));
@@ -35,9 +35,33 @@ namespace oak {
 		lua_setglobal(L, "oak");
 	}
 
+	//lua allocation callback, routes the interpreters memory through the lua tag
+	static void* luaAlloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+		auto allocator = static_cast<Allocator*>(ud);
+		if (nsize == 0) {
+			if (ptr != nullptr) {
+				allocator->deallocate(ptr, osize);
+			}
+			return nullptr;
+		}
+		void *nptr = allocator->allocate(nsize);
+		if (ptr != nullptr) {
+			//when ptr is null osize is a type code, not a size
+			memcpy(nptr, ptr, osize < nsize ? osize : nsize);
+			allocator->deallocate(ptr, osize);
+		}
+		return nptr;
+	}
+
+	static int luaPanic(lua_State *L) {
+		log_print_err("lua panic: %s", lua_tostring(L, -1));
+		return 0;
+	}
+
 	lua_State* luah::createState() {
 		log_print_out("creating the lua state");
-		lua_State *L = luaL_newstate();
+		lua_State *L = lua_newstate(luaAlloc, oalloc_tagged(MemoryTag::LUA));
+		lua_atpanic(L, luaPanic);
 		luaL_openlibs(L);
 
 		const char* luaFun0 = R"(function getKeys(t) 
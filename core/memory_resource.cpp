@@ -0,0 +1,49 @@
+#include "memory_resource.h"
+
+#include "util/ptr_util.h"
+#include "oak_assert.h"
+
+namespace oak {
+
+	AllocatorResource oak_resource{ &oalloc_sizeclass };
+
+	AllocatorResource::AllocatorResource(Allocator *allocator) : allocator_{ allocator } {}
+
+	void* AllocatorResource::do_allocate(size_t bytes, size_t alignment) {
+		if (alignment <= allocator_->getAlignment()) {
+			return allocator_->allocate(bytes);
+		}
+		//over aligned requests store the adjustment in front of the block
+		void *ptr = allocator_->allocate(bytes + alignment + sizeof(uint32_t));
+		uint32_t adjustment = ptrutil::alignForwardAdjustmentWithHeader(ptr, static_cast<uint32_t>(alignment), sizeof(uint32_t));
+		void *aligned = ptrutil::add(ptr, adjustment);
+		*static_cast<uint32_t*>(ptrutil::subtract(aligned, sizeof(uint32_t))) = adjustment;
+		return aligned;
+	}
+
+	void AllocatorResource::do_deallocate(void *ptr, size_t bytes, size_t alignment) {
+		if (alignment <= allocator_->getAlignment()) {
+			allocator_->deallocate(ptr, bytes);
+			return;
+		}
+		uint32_t adjustment = *static_cast<uint32_t*>(ptrutil::subtract(ptr, sizeof(uint32_t)));
+		allocator_->deallocate(ptrutil::subtract(ptr, adjustment), bytes + alignment + sizeof(uint32_t));
+	}
+
+	bool AllocatorResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		auto resource = dynamic_cast<const AllocatorResource*>(&other);
+		return resource != nullptr && resource->allocator_ == allocator_;
+	}
+
+	ResourceAllocator::ResourceAllocator(std::pmr::memory_resource *resource, uint32_t alignment) : 
+		Allocator{ nullptr, alignment }, resource_{ resource } {}
+
+	void* ResourceAllocator::allocate(size_t size) {
+		return resource_->allocate(size, alignment_);
+	}
+
+	void ResourceAllocator::deallocate(void *ptr, size_t size) {
+		resource_->deallocate(ptr, size, alignment_);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory_resource>
+
+#include "oak_alloc.h"
+
+namespace oak {
+
+	//std::pmr view of an oak allocator so engine memory can back pmr containers and third party code
+	class AllocatorResource : public std::pmr::memory_resource {
+	public:
+		explicit AllocatorResource(Allocator *allocator = &oalloc_sizeclass);
+
+		inline Allocator* getAllocator() const { return allocator_; }
+
+	private:
+		Allocator *allocator_;
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void *ptr, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+	};
+
+	//oak allocator that takes its memory from a memory resource,
+	//lets oak containers use a monotonic_buffer_resource over a stack buffer
+	class ResourceAllocator : public Allocator {
+	public:
+		explicit ResourceAllocator(std::pmr::memory_resource *resource, uint32_t alignment = 16);
+
+		void* allocate(size_t size) override;
+		void deallocate(void *ptr, size_t size) override;
+
+		inline std::pmr::memory_resource* getResource() const { return resource_; }
+
+	private:
+		std::pmr::memory_resource *resource_;
+	};
+
+	extern AllocatorResource oak_resource;
+
+}
\ No newline at end of file
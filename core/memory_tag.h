@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cinttypes>
+
+namespace oak {
+
+	//subsystems that memory can be accounted against
+	enum class MemoryTag : uint32_t {
+		GENERAL,
+		SCENE,
+		EVENTS,
+		RESOURCES,
+		GRAPHICS,
+		LUA,
+		AUDIO,
+		COUNT
+	};
+
+	constexpr size_t MEMORY_TAG_COUNT = static_cast<size_t>(MemoryTag::COUNT);
+
+}
\ No newline at end of file
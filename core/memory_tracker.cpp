@@ -0,0 +1,104 @@
+#include "memory_tracker.h"
+
+#include <atomic>
+#include <cstdio>
+
+namespace oak {
+
+	namespace memory {
+
+		static const char* tagNames[] = {
+			"general",
+			"scene",
+			"events",
+			"resources",
+			"graphics",
+			"lua",
+			"audio"
+		};
+
+		static_assert(sizeof(tagNames) / sizeof(tagNames[0]) == MEMORY_TAG_COUNT, "every memory tag needs a name");
+
+		const char* tagName(MemoryTag tag) {
+			return tag < MemoryTag::COUNT ? tagNames[static_cast<size_t>(tag)] : "unknown";
+		}
+
+#ifdef OAK_MEMORY_TRACKING
+		//each tag is on its own cache line since different subsystems allocate from different threads
+		struct alignas(64) TagCounters {
+			std::atomic<size_t> live{ 0 };
+			std::atomic<size_t> peak{ 0 };
+			std::atomic<size_t> allocs{ 0 };
+			std::atomic<size_t> frees{ 0 };
+			//only touched by sample
+			size_t lastAllocs = 0;
+			float rate = 0.0f;
+		};
+
+		static TagCounters counters[MEMORY_TAG_COUNT];
+
+		void trackAlloc(MemoryTag tag, size_t size) {
+			auto& c = counters[static_cast<size_t>(tag)];
+			c.allocs.fetch_add(1, std::memory_order_relaxed);
+			const size_t live = c.live.fetch_add(size, std::memory_order_relaxed) + size;
+			size_t peak = c.peak.load(std::memory_order_relaxed);
+			while (live > peak && !c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+		}
+
+		void trackFree(MemoryTag tag, size_t size) {
+			auto& c = counters[static_cast<size_t>(tag)];
+			c.frees.fetch_add(1, std::memory_order_relaxed);
+			c.live.fetch_sub(size, std::memory_order_relaxed);
+		}
+
+		MemoryStats getStats(MemoryTag tag) {
+			const auto& c = counters[static_cast<size_t>(tag)];
+			MemoryStats stats;
+			stats.liveBytes = c.live.load(std::memory_order_relaxed);
+			stats.peakBytes = c.peak.load(std::memory_order_relaxed);
+			stats.allocCount = c.allocs.load(std::memory_order_relaxed);
+			stats.freeCount = c.frees.load(std::memory_order_relaxed);
+			stats.allocRate = c.rate;
+			return stats;
+		}
+
+		void sample(float dt) {
+			if (dt <= 0.0f) { return; }
+			for (auto& c : counters) {
+				const size_t allocs = c.allocs.load(std::memory_order_relaxed);
+				c.rate = static_cast<float>(allocs - c.lastAllocs) / dt;
+				c.lastAllocs = allocs;
+			}
+		}
+
+		bool dump(const char *path) {
+			FILE *file = fopen(path, "w");
+			if (file == nullptr) { return false; }
+
+			fprintf(file, "%-12s%16s%16s%16s%16s%16s\n", "tag", "live", "peak", "allocs", "frees", "allocs/s");
+			for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+				const auto stats = getStats(static_cast<MemoryTag>(i));
+				fprintf(file, "%-12s%16zu%16zu%16zu%16zu%16.1f\n", tagNames[i],
+					stats.liveBytes, stats.peakBytes, stats.allocCount, stats.freeCount, stats.allocRate);
+			}
+
+			fclose(file);
+			return true;
+		}
+#endif
+
+	}
+
+	TaggedAllocator::TaggedAllocator(Allocator *parent, MemoryTag tag) : Allocator{ parent, parent->getAlignment() }, tag_{ tag } {}
+
+	void* TaggedAllocator::allocate(size_t size) {
+		memory::trackAlloc(tag_, size);
+		return parent_->allocate(size);
+	}
+
+	void TaggedAllocator::deallocate(void *ptr, size_t size) {
+		memory::trackFree(tag_, size);
+		parent_->deallocate(ptr, size);
+	}
+
+}
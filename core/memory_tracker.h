@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "allocators.h"
+#include "memory_tag.h"
+
+namespace oak {
+
+	struct MemoryStats {
+		size_t liveBytes = 0;
+		size_t peakBytes = 0;
+		size_t allocCount = 0;
+		size_t freeCount = 0;
+		float allocRate = 0.0f; //allocations per second between the last two samples
+	};
+
+	namespace memory {
+
+		const char* tagName(MemoryTag tag);
+
+		//when OAK_MEMORY_TRACKING isnt defined these are empty and the tagged allocators are never created
+#ifdef OAK_MEMORY_TRACKING
+		void trackAlloc(MemoryTag tag, size_t size);
+		void trackFree(MemoryTag tag, size_t size);
+		MemoryStats getStats(MemoryTag tag);
+		//updates the allocation rates, call once a frame from the main thread
+		void sample(float dt);
+		//writes a table of every tags stats to a file
+		bool dump(const char *path);
+#else
+		inline void trackAlloc(MemoryTag, size_t) {}
+		inline void trackFree(MemoryTag, size_t) {}
+		inline MemoryStats getStats(MemoryTag) { return {}; }
+		inline void sample(float) {}
+		inline bool dump(const char*) { return false; }
+#endif
+
+	}
+
+	//forwards to the parent and records every allocation against a tag
+	class TaggedAllocator : public Allocator {
+	public:
+		TaggedAllocator(Allocator *parent, MemoryTag tag);
+
+		void* allocate(size_t size) override;
+		void deallocate(void *ptr, size_t size) override;
+
+		MemoryTag getTag() const { return tag_; }
+
+	private:
+		MemoryTag tag_;
+	};
+
+}
@@ -4,9 +4,28 @@ namespace oak {
 
 	ProxyAllocator oalloc_proxy;
 	FreelistAllocator oalloc_freelist{ &oalloc_proxy, 128_mb, 64 };
-	LinearAllocator oalloc_frame{ &oalloc_freelist };
+	SizeClassAllocator oalloc_sizeclass{ &oalloc_freelist };
+	FrameAllocator oalloc_frame{ &oalloc_freelist };
 
-	OakAllocator<void> oak_allocator{ &oalloc_freelist };
+#ifdef OAK_MEMORY_TRACKING
+	TaggedAllocator oalloc_tags[MEMORY_TAG_COUNT] = {
+		{ &oalloc_sizeclass, MemoryTag::GENERAL },
+		{ &oalloc_sizeclass, MemoryTag::SCENE },
+		{ &oalloc_sizeclass, MemoryTag::EVENTS },
+		{ &oalloc_sizeclass, MemoryTag::RESOURCES },
+		{ &oalloc_sizeclass, MemoryTag::GRAPHICS },
+		{ &oalloc_sizeclass, MemoryTag::LUA },
+		{ &oalloc_sizeclass, MemoryTag::AUDIO }
+	};
+#endif
+
+	OakAllocator<void> oak_allocator{ &oalloc_sizeclass };
 	OakAllocator<void> frame_allocator{ &oalloc_frame };
+
+	StackAllocator& oalloc_scratch() {
+		//each thread has its own stack so scratch allocations need no locks
+		thread_local StackAllocator stack;
+		return stack;
+	}
 	
 }
@@ -1,15 +1,26 @@
 #pragma once
 
 #include <utility>
+#include <atomic>
 
 #include "allocators.h"
+#include "memory_tracker.h"
 #include "memory_literals.h"
 
 namespace oak {
 
 	extern ProxyAllocator oalloc_proxy;
 	extern FreelistAllocator oalloc_freelist;
-	extern LinearAllocator oalloc_frame;
+	extern SizeClassAllocator oalloc_sizeclass;
+	extern FrameAllocator oalloc_frame;
+
+	//allocator to use for a subsystems memory, without tracking every tag is just the size class allocator
+#ifdef OAK_MEMORY_TRACKING
+	extern TaggedAllocator oalloc_tags[MEMORY_TAG_COUNT];
+	inline Allocator* oalloc_tagged(MemoryTag tag) { return &oalloc_tags[static_cast<size_t>(tag)]; }
+#else
+	inline Allocator* oalloc_tagged(MemoryTag) { return &oalloc_sizeclass; }
+#endif
 
 	namespace detail {
 
@@ -25,7 +36,7 @@ namespace oak {
 
 	}
 	namespace debug::vars {
-		extern size_t usedMemory;
+		extern std::atomic<size_t> usedMemory;
 	}
 
 	//base allocator
@@ -48,18 +59,18 @@ namespace oak {
 			typedef OakAllocator<U> other;	
 		};
 
-		explicit OakAllocator(Allocator *allocator = &oalloc_freelist) : allocator_{ allocator } {}
+		explicit OakAllocator(Allocator *allocator = &oalloc_sizeclass) : allocator_{ allocator } {}
 
 		template<class U>
 		OakAllocator(const OakAllocator<U>& other) : allocator_{ other.allocator_ } {}
 
 		pointer allocate(size_t count, const_pointer locality = nullptr) {
-			debug::vars::usedMemory += count * value_size;
+			debug::vars::usedMemory.fetch_add(count * value_size, std::memory_order_relaxed);
 			return static_cast<pointer>(allocator_->allocate(count * value_size));
 		}
 
 		void deallocate(void *ptr, size_t count) {
-			debug::vars::usedMemory -= count * value_size;
+			debug::vars::usedMemory.fetch_sub(count * value_size, std::memory_order_relaxed);
 			allocator_->deallocate(ptr, count * value_size);
 		}
 
@@ -85,4 +96,27 @@ namespace oak {
 	extern OakAllocator<void> oak_allocator;
 	extern OakAllocator<void> frame_allocator;
 
-}
\ No newline at end of file
+	//scratch stack of the calling thread
+	StackAllocator& oalloc_scratch();
+
+	//marks the scratch stack when created and rolls it back when destroyed, releasing everything allocated in the scope at once
+	//containers using the arena must not outlive it or grow while a nested arena is alive
+	class ScopedArena {
+	public:
+		explicit ScopedArena(StackAllocator& stack = oalloc_scratch()) : stack_{ stack }, marker_{ stack.getMarker() } {}
+		~ScopedArena() { stack_.rollback(marker_); }
+
+		ScopedArena(const ScopedArena&) = delete;
+		void operator=(const ScopedArena&) = delete;
+
+		inline void* allocate(size_t size) { return stack_.allocate(size); }
+
+		template<class T = void>
+		OakAllocator<T> allocator() const { return OakAllocator<T>{ &stack_ }; }
+
+	private:
+		StackAllocator& stack_;
+		size_t marker_;
+	};
+
+}
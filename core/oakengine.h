@@ -2,6 +2,7 @@
 
 #include <type_traits>
 #include <utility>
+#include <tuple>
 
 #include "oak_assert.h"
 
@@ -14,14 +15,16 @@
 #include "scene.h"
 #include "component.h"
 #include "component_storage.h"
+#include "entity_cache.h"
+#include "job_manager.h"
 #include "log.h"
 
 namespace oak {
 
 	//event api
 	template<class T>
-	void addEventQueue() {
-		EventManager::inst().addQueue(&T::typeInfo);
+	void addEventQueue(bool doubleBuffered = false, size_t reserveSize = config::EVENT_RESERVE_SIZE) {
+		EventManager::inst().addQueue(&T::typeInfo, doubleBuffered, reserveSize);
 	}
 
 	template<class T>
@@ -40,7 +43,7 @@ namespace oak {
 		auto& storage = ResourceManager::inst().get(&T::typeInfo);
 		auto ptr = storage.setDefault();
 		new (ptr) T{ std::forward<TArgs>(args)... };
-		return *ptr;
+		return *static_cast<T*>(ptr);
 	}
 	
 	template<class T, class... TArgs>
@@ -125,5 +128,32 @@ namespace oak {
 		return scene.hasComponent(entity, T::typeInfo.id);
 	}
 
+	namespace config {
+		constexpr size_t ENTITY_CHUNK_SIZE = 1024; //default number of entities handed to each job
+	}
+
+	//calls func(begin, end) with chunks of the cached entities on the job manager threads and waits for them to finish
+	template<class F>
+	void parallelForChunks(const EntityCache& cache, F&& func, size_t chunkSize = config::ENTITY_CHUNK_SIZE) {
+		const auto& entities = cache.entities();
+		JobManager::inst().parallelFor(entities.size(), chunkSize, [&entities, &func](size_t begin, size_t end) {
+			func(entities.data() + begin, entities.data() + end);
+		});
+	}
+
+	//calls func(entity, components...) for every cached entity on the job manager threads
+	//the component storages are looked up once per chunk, func must only touch the entity it is given
+	template<class... T, class F>
+	void parallelForEach(const EntityCache& cache, Scene& scene, F&& func, size_t chunkSize = config::ENTITY_CHUNK_SIZE) {
+		parallelForChunks(cache, [&scene, &func](const EntityId *begin, const EntityId *end) {
+			std::tuple<mpl::const_type<T, ComponentStorage>&...> storages{ getComponentStorage<T>(scene)... };
+			std::apply([begin, end, &func](auto&... storage) {
+				for (auto it = begin; it != end; it++) {
+					func(*it, getComponent<T>(*it, storage)...);
+				}
+			}, storages);
+		}, chunkSize);
+	}
+
 }
 
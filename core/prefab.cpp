@@ -29,7 +29,7 @@ namespace oak {
 
 	void* Prefab::addComponent(size_t tid) {
 		auto ti = ComponentTypeManager::inst().getTypeInfo(tid);
-		void *comp = oak_allocator.allocate(ti->size);
+		void *comp = oalloc_tagged(MemoryTag::SCENE)->allocate(ti->size);
 		ti->construct(comp);
 		//ensure size
 		if (tid >= storage_.size()) {
@@ -45,7 +45,7 @@ namespace oak {
 			if (it != nullptr) {
 				auto ti = ComponentTypeManager::inst().getTypeInfo(i);
 				ti->destruct(it);
-				oak_allocator.deallocate(it, ti->size);
+				oalloc_tagged(MemoryTag::SCENE)->deallocate(it, ti->size);
 			}
 		}
 		storage_.clear();
@@ -15,7 +15,7 @@ namespace oak {
 		auto id = resource.id;
 		puper.pup(resource.id, info);
 		if (id != resource.id) {
-			resource.ptr = nullptr;
+			resource.handle = ResourceHandle{};
 		}
 	}
 
@@ -24,37 +24,45 @@ namespace oak {
 		template<class TF> 
 		friend void pup(Puper& puper, Resource<TF>& resource, const ObjInfo& info);
 
-		Resource() : id{ 0 }, ptr{ nullptr } {}
-		Resource(size_t i, const T* p = nullptr) : id{ i }, ptr{ p } {}
+		Resource() : id{ 0 }, handle{ ResourceHandle{} } {}
+		Resource(size_t i) : id{ i }, handle{ ResourceHandle{} } {}
 		Resource(const oak::string& name) : Resource(std::hash<oak::string>{}(name)) {}
 
-		Resource(const Resource& other) : id{ other.id }, ptr{ other.ptr.load() } {}
-		inline void operator=(const Resource& other) { id = other.id; ptr = other.ptr.load(); }
+		Resource(const Resource& other) : id{ other.id }, handle{ other.handle.load(std::memory_order_relaxed) } {}
+		inline void operator=(const Resource& other) { id = other.id; handle.store(other.handle.load(std::memory_order_relaxed), std::memory_order_relaxed); }
 
 		inline const T operator*() const {
-			get();
-			return *ptr;
+			return *get();
 		}
 
 		inline const T* operator->() const {
-			get();
-			return ptr;
+			return get();
 		}
 
 		inline operator const T*() const {
-			get();
-			return ptr;
+			return get();
 		}
 
-		inline void get() const {
-			if (!ptr) {
-				ptr = static_cast<const T*>(ResourceManager::inst().get(&T::typeInfo).require(id));
+		//the id is looked up once, after that the handle resolves with one array index until the resource is removed
+		//the default resource is never cached so the handle picks up the resource once it has been loaded
+		inline const T* get() const {
+			auto& storage = ResourceManager::inst().get(&T::typeInfo);
+			auto p = static_cast<const T*>(storage.resolve(handle.load(std::memory_order_relaxed)));
+			if (!p) {
+				const auto h = storage.getHandle(id);
+				p = static_cast<const T*>(storage.resolve(h));
+				if (p) {
+					handle.store(h, std::memory_order_relaxed);
+				} else {
+					p = static_cast<const T*>(storage.getDefault());
+				}
 			}
-			oak_assert(ptr);
+			oak_assert(p);
+			return p;
 		}
 
 		size_t id = 0;
-		mutable std::atomic<const T*> ptr = nullptr;
+		mutable std::atomic<ResourceHandle> handle;
 	};
 
 }
@@ -0,0 +1,181 @@
+#include "resource_loader.h"
+
+#include <algorithm>
+
+namespace oak {
+
+	namespace {
+		bool lowerPriority(const detail::LoadTask *a, const detail::LoadTask *b) {
+			return a->priority < b->priority || (a->priority == b->priority && a->order > b->order);
+		}
+	}
+
+	ResourceLoader *ResourceLoader::instance = nullptr;
+
+	ResourceLoader::ResourceLoader(size_t threadCount) {
+		oak_assert(instance == nullptr);
+		instance = this;
+
+		oak_assert(threadCount > 0);
+		for (size_t i = 0; i < threadCount; i++) {
+			threads_.emplace_back([this]() { work(); });
+		}
+	}
+
+	ResourceLoader::~ResourceLoader() {
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			running_ = false;
+		}
+		workCondition_.notify_all();
+		for (auto& thread : threads_) {
+			thread.join();
+		}
+		//loads that were not published are dropped
+		for (const auto& entry : queue_) {
+			release(entry);
+		}
+		for (const auto& entry : finished_) {
+			release(entry);
+		}
+		instance = nullptr;
+	}
+
+	bool ResourceLoader::raise(const TypeInfo *typeInfo, size_t id, int priority) {
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		for (auto& entry : queue_) {
+			if (entry.task->typeInfo == typeInfo && entry.task->id == id) {
+				if (priority > entry.task->priority) {
+					entry.task->priority = priority;
+					std::make_heap(std::begin(queue_), std::end(queue_), [](const Entry& a, const Entry& b) { return lowerPriority(a.task, b.task); });
+				}
+				return true;
+			}
+		}
+		//a load that is already decoding or waiting to be published is only reused if it was not cancelled
+		for (const auto list : { &decoding_, &finished_ }) {
+			for (const auto& entry : *list) {
+				if (entry.task->typeInfo == typeInfo && entry.task->id == id && !entry.task->cancelled) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void ResourceLoader::submit(detail::LoadTask *task, size_t size, const TypeInfo *typeInfo, size_t id, int priority) {
+		task->typeInfo = typeInfo;
+		task->id = id;
+		task->priority = priority;
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			task->order = order_++;
+			queue_.push_back({ task, size });
+			std::push_heap(std::begin(queue_), std::end(queue_), [](const Entry& a, const Entry& b) { return lowerPriority(a.task, b.task); });
+			pendingCount_++;
+		}
+		workCondition_.notify_one();
+	}
+
+	bool ResourceLoader::cancel(const TypeInfo *typeInfo, size_t id) {
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		bool found = false;
+		//queued and finished loads are released right away, a load that is decoding is released by update once it finishes
+		for (auto list : { &queue_, &finished_ }) {
+			auto it = std::find_if(std::begin(*list), std::end(*list), [typeInfo, id](const Entry& entry) {
+				return entry.task->typeInfo == typeInfo && entry.task->id == id && !entry.task->cancelled;
+			});
+			if (it != std::end(*list)) {
+				release(*it);
+				list->erase(it);
+				pendingCount_--;
+				found = true;
+			}
+		}
+		std::make_heap(std::begin(queue_), std::end(queue_), [](const Entry& a, const Entry& b) { return lowerPriority(a.task, b.task); });
+		for (auto& entry : decoding_) {
+			if (entry.task->typeInfo == typeInfo && entry.task->id == id && !entry.task->cancelled) {
+				entry.task->cancelled = true;
+				found = true;
+			}
+		}
+		if (found) {
+			doneCondition_.notify_all();
+		}
+		return found;
+	}
+
+	bool ResourceLoader::isLoading(const TypeInfo *typeInfo, size_t id) {
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		for (const auto list : { &queue_, &decoding_, &finished_ }) {
+			for (const auto& entry : *list) {
+				if (entry.task->typeInfo == typeInfo && entry.task->id == id && !entry.task->cancelled) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void ResourceLoader::update() {
+		oak::vector<Entry> finished;
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			finished.swap(finished_);
+		}
+		if (finished.empty()) { return; }
+
+		for (const auto& entry : finished) {
+			if (!entry.task->cancelled) {
+				entry.task->publish();
+				pendingCount_--;
+			}
+			release(entry);
+		}
+		doneCondition_.notify_all();
+	}
+
+	void ResourceLoader::finish() {
+		while (pendingCount_ > 0) {
+			{
+				std::unique_lock<std::mutex> lock{ mutex_ };
+				doneCondition_.wait(lock, [this]() { return !finished_.empty() || pendingCount_ == 0; });
+			}
+			update();
+		}
+	}
+
+	void ResourceLoader::release(const Entry& entry) {
+		entry.task->~LoadTask();
+		oalloc_tagged(MemoryTag::RESOURCES)->deallocate(entry.task, entry.size);
+	}
+
+	void ResourceLoader::work() {
+		while (true) {
+			Entry entry;
+			{
+				std::unique_lock<std::mutex> lock{ mutex_ };
+				workCondition_.wait(lock, [this]() { return !running_ || !queue_.empty(); });
+				if (!running_) { return; }
+				std::pop_heap(std::begin(queue_), std::end(queue_), [](const Entry& a, const Entry& b) { return lowerPriority(a.task, b.task); });
+				entry = queue_.back();
+				queue_.pop_back();
+				decoding_.push_back(entry);
+			}
+
+			entry.task->decode();
+
+			{
+				std::lock_guard<std::mutex> lock{ mutex_ };
+				decoding_.erase(std::find_if(std::begin(decoding_), std::end(decoding_), [&entry](const Entry& e) { return e.task == entry.task; }));
+				if (entry.task->cancelled) {
+					//cancelled while decoding, the pending count was not changed by cancel
+					pendingCount_--;
+				}
+				finished_.push_back(entry);
+			}
+			doneCondition_.notify_all();
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <utility>
+#include <type_traits>
+
+#include "oak_assert.h"
+#include "container.h"
+#include "resource_manager.h"
+#include "resource.h"
+
+namespace oak {
+
+	namespace config {
+		constexpr size_t LOADER_THREADS = 2;
+	}
+
+	namespace detail {
+		//a pending load, decode runs on a loader thread and publish runs on the thread that calls update
+		struct LoadTask {
+			virtual ~LoadTask() {}
+			virtual void decode() = 0;
+			virtual void publish() = 0;
+
+			const TypeInfo *typeInfo;
+			size_t id;
+			int priority;
+			uint64_t order;
+			std::atomic<bool> cancelled{ false };
+		};
+
+		template<class T, class Decode, class Create>
+		struct LoadTaskImpl : LoadTask {
+			using Decoded = std::decay_t<std::invoke_result_t<Decode&>>;
+
+			template<class D, class C>
+			LoadTaskImpl(D&& d, C&& c) : decodeFunc{ std::forward<D>(d) }, createFunc{ std::forward<C>(c) } {}
+
+			void decode() override {
+				decoded.emplace(decodeFunc());
+			}
+
+			void publish() override {
+				auto ptr = ResourceManager::inst().get(&T::typeInfo).add(id);
+				new (ptr) T{ createFunc(*decoded) };
+			}
+
+			Decode decodeFunc;
+			Create createFunc;
+			std::optional<Decoded> decoded;
+		};
+	}
+
+	//loads resources on background threads so the main thread does not stall on file io and decoding
+	//a load returns a handle right away, the handle points at the default resource until the load is published by update
+	class ResourceLoader {
+	private:
+		static ResourceLoader *instance;
+	public:
+		inline static ResourceLoader& inst() {
+			oak_assert(instance != nullptr);
+			return *instance;
+		}
+
+		ResourceLoader(size_t threadCount = config::LOADER_THREADS);
+		~ResourceLoader();
+
+		//decode is called on a loader thread and must not touch the graphics api, create is called on the
+		//thread that calls update with the decoded value and returns the resource (eg. uploads a texture)
+		//higher priority loads are decoded first, loading a resource that is already pending raises its priority
+		template<class T, class Decode, class Create>
+		Resource<T> load(size_t id, int priority, Decode&& decode, Create&& create) {
+			using Task = detail::LoadTaskImpl<T, std::decay_t<Decode>, std::decay_t<Create>>;
+			if (!raise(&T::typeInfo, id, priority)) {
+				auto task = static_cast<Task*>(oalloc_tagged(MemoryTag::RESOURCES)->allocate(sizeof(Task)));
+				new (task) Task{ std::forward<Decode>(decode), std::forward<Create>(create) };
+				submit(task, sizeof(Task), &T::typeInfo, id, priority);
+			}
+			return Resource<T>{ id };
+		}
+
+		template<class T, class Decode, class Create>
+		Resource<T> load(const oak::string& name, int priority, Decode&& decode, Create&& create) {
+			return load<T>(std::hash<oak::string>{}(name), priority, std::forward<Decode>(decode), std::forward<Create>(create));
+		}
+
+		//decode returns the resource itself
+		template<class T, class Decode>
+		Resource<T> load(const oak::string& name, int priority, Decode&& decode) {
+			return load<T>(name, priority, std::forward<Decode>(decode), [](T& decoded) { return std::move(decoded); });
+		}
+
+		//a cancelled load is never published, returns false if there was no pending load
+		bool cancel(const TypeInfo *typeInfo, size_t id);
+
+		template<class T>
+		bool cancel(const oak::string& name) {
+			return cancel(&T::typeInfo, std::hash<oak::string>{}(name));
+		}
+
+		bool isLoading(const TypeInfo *typeInfo, size_t id);
+
+		template<class T>
+		bool isLoading(const oak::string& name) {
+			return isLoading(&T::typeInfo, std::hash<oak::string>{}(name));
+		}
+
+		//publishes the finished loads, called once a frame at a point where no other thread reads resources
+		void update();
+		//blocks until every pending load is finished and published
+		void finish();
+
+		inline size_t getPendingCount() const { return pendingCount_; }
+
+	private:
+		struct Entry {
+			detail::LoadTask *task;
+			size_t size;
+		};
+
+		oak::vector<std::thread> threads_;
+		std::mutex mutex_;
+		std::condition_variable workCondition_;
+		std::condition_variable doneCondition_;
+		//heap ordered by priority then by submission order
+		oak::vector<Entry> queue_;
+		oak::vector<Entry> decoding_;
+		oak::vector<Entry> finished_;
+		uint64_t order_ = 0;
+		std::atomic<size_t> pendingCount_{ 0 };
+		bool running_ = true;
+
+		bool raise(const TypeInfo *typeInfo, size_t id, int priority);
+		void submit(detail::LoadTask *task, size_t size, const TypeInfo *typeInfo, size_t id, int priority);
+		void release(const Entry& entry);
+		void work();
+	};
+
+}
\ No newline at end of file
@@ -4,13 +4,14 @@
 
 namespace oak {
 
-	ResourceStorage::ResourceStorage(const TypeInfo *tinfo, oak::Allocator *allocator, size_t pageSize) : defaultResource_{ nullptr }, allocator_{ allocator, pageSize, tinfo->size }, typeInfo_{ tinfo } {};
+	ResourceStorage::ResourceStorage(const TypeInfo *tinfo, oak::Allocator *allocator, size_t pageSize) : resources_{ allocator }, defaultResource_{ nullptr }, allocator_{ allocator, pageSize, tinfo->size, 8, MemoryTag::RESOURCES }, typeInfo_{ tinfo } {};
 
 	ResourceStorage::~ResourceStorage() {
 		for (auto it : resources_) {
-			typeInfo_->destroy(it.second);
-			typeInfo_->destruct(it.second);
-			allocator_.deallocate(it.second, typeInfo_->size);
+			auto ptr = slots_[it.second].ptr;
+			typeInfo_->destroy(ptr);
+			typeInfo_->destruct(ptr);
+			allocator_.deallocate(ptr, typeInfo_->size);
 		}
 		resources_.clear();
 	}
@@ -29,10 +30,20 @@ namespace oak {
 		auto it = resources_.find(id);
 		if (it == std::end(resources_)) {
 			auto ptr = allocator_.allocate(typeInfo_->size);
-			resources_.insert({ id, ptr });
+			uint32_t index;
+			if (freeSlots_.empty()) {
+				index = static_cast<uint32_t>(slots_.size());
+				slots_.push_back({ ptr, 0 });
+			} else {
+				index = freeSlots_.back();
+				freeSlots_.pop_back();
+				slots_[index].ptr = ptr;
+			}
+			resources_.insert({ id, index });
 			return ptr;
 		} else {
-			auto ptr = it->second;
+			//reloads keep the slot so existing handles stay valid
+			auto ptr = slots_[it->second].ptr;
 			typeInfo_->destroy(ptr);
 			typeInfo_->destruct(ptr);
 			return ptr;
@@ -42,10 +53,14 @@ namespace oak {
 	void ResourceStorage::remove(size_t id) {
 		auto it = resources_.find(id);
 		if (it != std::end(resources_)) {
-			auto ptr = it->second;
-			typeInfo_->destroy(ptr);
-			typeInfo_->destruct(ptr);
-			allocator_.deallocate(ptr, typeInfo_->size);
+			auto& slot = slots_[it->second];
+			typeInfo_->destroy(slot.ptr);
+			typeInfo_->destruct(slot.ptr);
+			allocator_.deallocate(slot.ptr, typeInfo_->size);
+			//the new generation makes the handles to this slot stale
+			slot.ptr = nullptr;
+			slot.generation++;
+			freeSlots_.push_back(it->second);
 			resources_.erase(it);
 		}
 	}
@@ -53,7 +68,7 @@ namespace oak {
 	void* ResourceStorage::require(size_t id) {
 		auto it = resources_.find(id);
 		if (it != std::end(resources_)) {
-			return it->second;
+			return slots_[it->second].ptr;
 		} else if (defaultResource_ != nullptr) {
 			return defaultResource_;
 		}
@@ -65,6 +80,14 @@ namespace oak {
 		return it != std::end(resources_);
 	}
 
+	ResourceHandle ResourceStorage::getHandle(size_t id) const {
+		auto it = resources_.find(id);
+		if (it != std::end(resources_)) {
+			return { it->second, slots_[it->second].generation };
+		}
+		return {};
+	}
+
 	ResourceManager *ResourceManager::instance = nullptr;
 
 	ResourceManager::ResourceManager() {
@@ -78,7 +101,7 @@ namespace oak {
 		for (auto it : resourceHandles_) {
 			if (it != nullptr) {
 				it->~ResourceStorage();
-				oak_allocator.deallocate(it, sizeof(ResourceStorage));
+				oalloc_tagged(MemoryTag::RESOURCES)->deallocate(it, sizeof(ResourceStorage));
 			}
 		}
 		resourceHandles_.clear();
@@ -90,7 +113,7 @@ namespace oak {
 			if (resourceHandles_.size() <= tid) { 
 				resourceHandles_.resize(tid + 1);
 			}
-			auto ptr = static_cast<ResourceStorage*>(oak_allocator.allocate(sizeof(ResourceStorage)));
+			auto ptr = static_cast<ResourceStorage*>(oalloc_tagged(MemoryTag::RESOURCES)->allocate(sizeof(ResourceStorage)));
 			new (ptr) ResourceStorage{ tinfo };
 			resourceHandles_[tid] = ptr;
 			return *ptr;
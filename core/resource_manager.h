@@ -16,19 +16,50 @@ namespace oak {
 		return makeTypeInfo<detail::BaseResource, T>(name);
 	}
 
+	//index and generation of a resource slot, resolving a handle is one array index instead of a map lookup
+	//the handle stays valid when its resource is reloaded and goes stale when the resource is removed
+	struct ResourceHandle {
+		static constexpr uint32_t INVALID = ~uint32_t{ 0 };
+
+		uint32_t index = INVALID;
+		uint32_t generation = 0;
+	};
+
 	class ResourceStorage {
 	public:
-		ResourceStorage(const TypeInfo *tinfo, oak::Allocator *allocator = &oalloc_freelist, size_t pageSize = 10_mb);
+		ResourceStorage(const TypeInfo *tinfo, oak::Allocator *allocator = oalloc_tagged(MemoryTag::RESOURCES), size_t pageSize = 10_mb);
 
 		~ResourceStorage();
 
 		void* setDefault();
+		inline const void* getDefault() const { return defaultResource_; }
 		void* add(size_t id);
 		void remove(size_t id);
 		void* require(size_t id);
 		bool has(size_t id);
+
+		ResourceHandle getHandle(size_t id) const;
+		//returns nullptr for stale handles
+		inline void* resolve(ResourceHandle handle) const {
+			if (handle.index < slots_.size() && slots_[handle.index].generation == handle.generation) {
+				return slots_[handle.index].ptr;
+			}
+			return nullptr;
+		}
+
+		//returns unused pages to the parent allocator
+		inline void trim() { allocator_.trim(); }
+		inline float getFragmentation() const { return allocator_.getFragmentation(); }
 	private:
-		oak::unordered_map<size_t, void*> resources_;
+		struct Slot {
+			void *ptr;
+			uint32_t generation;
+		};
+
+		//maps resource ids to slots
+		oak::hash_map<size_t, uint32_t> resources_;
+		oak::vector<Slot> slots_;
+		oak::vector<uint32_t> freeSlots_;
 		void *defaultResource_;
 		PoolAllocator allocator_;
 		const TypeInfo *typeInfo_;
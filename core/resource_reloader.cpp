@@ -0,0 +1,175 @@
+#include "resource_reloader.h"
+
+#include <algorithm>
+#include <experimental/filesystem>
+
+#include "file_manager.h"
+#include "log.h"
+
+namespace oak {
+namespace fs = std::experimental::filesystem;
+
+	ResourceReloader *ResourceReloader::instance = nullptr;
+
+	ResourceReloader::ResourceReloader() {
+		oak_assert(instance == nullptr);
+		instance = this;
+		watchMounts();
+	}
+
+	ResourceReloader::~ResourceReloader() {
+		for (auto& node : nodes_) {
+			if (node.source != nullptr) {
+				node.source->~ReloadSource();
+				oalloc_tagged(MemoryTag::RESOURCES)->deallocate(node.source, node.sourceSize);
+			}
+		}
+		instance = nullptr;
+	}
+
+	void ResourceReloader::addDependency(const TypeInfo *typeInfo, size_t id, const TypeInfo *dependencyType, size_t dependency) {
+		const uint32_t node = findNode(typeInfo, id);
+		auto& dependents = nodes_[findNode(dependencyType, dependency)].dependents;
+		if (std::find(std::begin(dependents), std::end(dependents), node) == std::end(dependents)) {
+			dependents.push_back(node);
+		}
+	}
+
+	void ResourceReloader::reload(const TypeInfo *typeInfo, size_t id) {
+		schedule({ findNode(typeInfo, id) });
+	}
+
+	void ResourceReloader::update() {
+		watchMounts();
+
+		changed_.clear();
+		watcher_.poll(changed_);
+		if (!changed_.empty()) {
+			oak::vector<uint32_t> nodes;
+			for (const auto& path : changed_) {
+				auto it = files_.find(path);
+				if (it != std::end(files_)) {
+					log_print_out("reloading: %s", path.c_str());
+					nodes.insert(std::end(nodes), std::begin(it->second), std::end(it->second));
+				}
+			}
+			if (!nodes.empty()) {
+				schedule(nodes);
+			}
+		}
+
+		//the next wave starts once every reload in the current one has been published
+		for (auto node : wave_) {
+			if (ResourceLoader::inst().isLoading(nodes_[node].typeInfo, nodes_[node].id)) {
+				return;
+			}
+		}
+		wave_.clear();
+		if (scheduled_.empty()) { return; }
+
+		const uint32_t depth = scheduled_.front().first;
+		auto it = std::begin(scheduled_);
+		for (; it != std::end(scheduled_) && it->first == depth; ++it) {
+			auto& node = nodes_[it->second];
+			if (node.source != nullptr) {
+				node.source->load(node.id, config::RELOAD_PRIORITY);
+				wave_.push_back(it->second);
+			}
+		}
+		scheduled_.erase(std::begin(scheduled_), it);
+	}
+
+	size_t ResourceReloader::key(const TypeInfo *typeInfo, size_t id) {
+		return id ^ ((typeInfo->id + 1) * 11400714819323198485ull);
+	}
+
+	uint32_t ResourceReloader::findNode(const TypeInfo *typeInfo, size_t id) {
+		auto it = nodeMap_.find(key(typeInfo, id));
+		if (it != std::end(nodeMap_)) {
+			oak_assert(nodes_[it->second].typeInfo == typeInfo && nodes_[it->second].id == id);
+			return it->second;
+		}
+		//resources that are only known as a dependency get a node without a source
+		const uint32_t index = static_cast<uint32_t>(nodes_.size());
+		nodes_.push_back({ typeInfo, id, {}, {}, nullptr, 0 });
+		nodeMap_.insert({ key(typeInfo, id), index });
+		return index;
+	}
+
+	void ResourceReloader::addNode(const TypeInfo *typeInfo, size_t id, const oak::vector<oak::string>& paths, detail::ReloadSource *source, size_t sourceSize) {
+		const uint32_t index = findNode(typeInfo, id);
+		auto& node = nodes_[index];
+		if (node.source != nullptr) {
+			node.source->~ReloadSource();
+			oalloc_tagged(MemoryTag::RESOURCES)->deallocate(node.source, node.sourceSize);
+		}
+		node.source = source;
+		node.sourceSize = sourceSize;
+
+		for (const auto& path : paths) {
+			const auto resolved = FileManager::inst().resolvePath(path);
+			std::error_code error;
+			auto canonical = fs::canonical(resolved.c_str(), error);
+			if (error) {
+				log_print_warn("cannot watch resource file: %s", path.c_str());
+				continue;
+			}
+			oak::string file{ canonical.c_str() };
+			auto& nodes = files_[file];
+			if (std::find(std::begin(nodes), std::end(nodes), index) == std::end(nodes)) {
+				nodes.push_back(index);
+				node.paths.push_back(std::move(file));
+			}
+		}
+	}
+
+	void ResourceReloader::schedule(const oak::vector<uint32_t>& changed) {
+		//the changed nodes, everything that depends on them and the nodes still waiting from earlier changes
+		oak::vector<uint32_t> affected;
+		for (const auto& it : scheduled_) {
+			affected.push_back(it.second);
+		}
+		for (size_t i = 0; i < changed.size(); i++) {
+			if (std::find(std::begin(affected), std::end(affected), changed[i]) == std::end(affected)) {
+				affected.push_back(changed[i]);
+			}
+		}
+		for (size_t i = 0; i < affected.size(); i++) {
+			for (auto dependent : nodes_[affected[i]].dependents) {
+				if (std::find(std::begin(affected), std::end(affected), dependent) == std::end(affected)) {
+					affected.push_back(dependent);
+				}
+			}
+		}
+
+		//a node is reloaded one wave after the deepest of its dependencies, cycles stop growing after affected.size() passes
+		oak::vector<uint32_t> depths(nodes_.size(), 0);
+		for (size_t pass = 0; pass < affected.size(); pass++) {
+			bool changedDepth = false;
+			for (auto node : affected) {
+				for (auto dependent : nodes_[node].dependents) {
+					if (depths[dependent] < depths[node] + 1) {
+						depths[dependent] = depths[node] + 1;
+						changedDepth = true;
+					}
+				}
+			}
+			if (!changedDepth) { break; }
+		}
+
+		scheduled_.clear();
+		for (auto node : affected) {
+			scheduled_.push_back({ depths[node], node });
+		}
+		std::stable_sort(std::begin(scheduled_), std::end(scheduled_), [](const auto& a, const auto& b) { return a.first < b.first; });
+	}
+
+	void ResourceReloader::watchMounts() {
+		//directories mounted since the last call
+		const auto& mounts = FileManager::inst().getMountPaths();
+		for (; watchedMounts_ < mounts.size(); watchedMounts_++) {
+			watcher_.watch(mounts[watchedMounts_]);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <utility>
+#include <type_traits>
+
+#include "oak_assert.h"
+#include "container.h"
+#include "file_watcher.h"
+#include "resource_loader.h"
+
+namespace oak {
+
+	namespace config {
+		//reloads are decoded before the loads that were already queued
+		constexpr int RELOAD_PRIORITY = 100;
+	}
+
+	namespace detail {
+		//issues a load of a resource through the resource loader, once when it is added and again for every reload
+		struct ReloadSource {
+			virtual ~ReloadSource() {}
+			virtual void load(size_t id, int priority) = 0;
+		};
+
+		template<class T, class Decode, class Create>
+		struct ReloadSourceImpl : ReloadSource {
+			template<class D, class C>
+			ReloadSourceImpl(D&& d, C&& c) : decode{ std::forward<D>(d) }, create{ std::forward<C>(c) } {}
+
+			void load(size_t id, int priority) override {
+				//a load of the old file that is still in flight is replaced
+				ResourceLoader::inst().cancel(&T::typeInfo, id);
+				ResourceLoader::inst().load<T>(id, priority, decode, create);
+			}
+
+			Decode decode;
+			Create create;
+		};
+	}
+
+	//reloads resources when the files they were loaded from change on disk
+	//a resource is reloaded after the resources it depends on (eg. a material after its shader) have been published
+	//the reloaded resource replaces the old one in its storage slot so existing handles see the new resource
+	class ResourceReloader {
+	private:
+		static ResourceReloader *instance;
+	public:
+		inline static ResourceReloader& inst() {
+			oak_assert(instance != nullptr);
+			return *instance;
+		}
+
+		ResourceReloader();
+		~ResourceReloader();
+
+		//loads the resource through the resource loader and loads it again when one of its files changes
+		//the paths are virtual paths, decode and create are called the same way as in ResourceLoader::load
+		template<class T, class Decode, class Create>
+		Resource<T> load(const oak::string& name, const oak::vector<oak::string>& paths, Decode&& decode, Create&& create, int priority = 0) {
+			using Source = detail::ReloadSourceImpl<T, std::decay_t<Decode>, std::decay_t<Create>>;
+			auto source = static_cast<Source*>(oalloc_tagged(MemoryTag::RESOURCES)->allocate(sizeof(Source)));
+			new (source) Source{ std::forward<Decode>(decode), std::forward<Create>(create) };
+			const size_t id = std::hash<oak::string>{}(name);
+			addNode(&T::typeInfo, id, paths, source, sizeof(Source));
+			source->load(id, priority);
+			return Resource<T>{ id };
+		}
+
+		template<class T, class Decode>
+		Resource<T> load(const oak::string& name, const oak::vector<oak::string>& paths, Decode&& decode, int priority = 0) {
+			return load<T>(name, paths, std::forward<Decode>(decode), [](T& decoded) { return std::move(decoded); }, priority);
+		}
+
+		//resource T name is reloaded whenever resource D dependency is reloaded
+		template<class T, class D>
+		void addDependency(const oak::string& name, const oak::string& dependency) {
+			addDependency(&T::typeInfo, std::hash<oak::string>{}(name), &D::typeInfo, std::hash<oak::string>{}(dependency));
+		}
+
+		void addDependency(const TypeInfo *typeInfo, size_t id, const TypeInfo *dependencyType, size_t dependency);
+
+		//reloads the resource and everything that depends on it
+		void reload(const TypeInfo *typeInfo, size_t id);
+
+		template<class T>
+		void reload(const oak::string& name) {
+			reload(&T::typeInfo, std::hash<oak::string>{}(name));
+		}
+
+		//checks the watched directories for changes and issues the next wave of reloads once the previous one has been published
+		//called once a frame before ResourceLoader::update
+		void update();
+
+		inline bool isReloading() const { return !scheduled_.empty() || !wave_.empty(); }
+
+	private:
+		struct Node {
+			const TypeInfo *typeInfo;
+			size_t id;
+			//canonical paths of the files the resource is loaded from
+			oak::vector<oak::string> paths;
+			oak::vector<uint32_t> dependents;
+			detail::ReloadSource *source;
+			size_t sourceSize;
+		};
+
+		FileWatcher watcher_;
+		size_t watchedMounts_ = 0;
+		oak::vector<oak::string> changed_;
+
+		oak::vector<Node> nodes_;
+		oak::hash_map<size_t, uint32_t> nodeMap_;
+		//canonical file path to the nodes loaded from it
+		oak::hash_map<oak::string, oak::vector<uint32_t>> files_;
+
+		//nodes waiting to be reloaded and the depth of each in the dependency graph
+		oak::vector<std::pair<uint32_t, uint32_t>> scheduled_;
+		//nodes whose reload has been issued but not published
+		oak::vector<uint32_t> wave_;
+
+		static size_t key(const TypeInfo *typeInfo, size_t id);
+		uint32_t findNode(const TypeInfo *typeInfo, size_t id);
+		void addNode(const TypeInfo *typeInfo, size_t id, const oak::vector<oak::string>& paths, detail::ReloadSource *source, size_t sourceSize);
+		void schedule(const oak::vector<uint32_t>& changed);
+		void watchMounts();
+	};
+
+}
\ No newline at end of file
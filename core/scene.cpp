@@ -1,16 +1,52 @@
 #include "scene.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "util/stream_puper.h"
+#include "util/byte_buffer.h"
+#include "util/hash_puper.h"
 #include "type_manager.h"
 #include "oakengine.h"
 #include "file_manager.h"
 #include "scene_events.h"
 #include "component_storage.h"
+#include "archetype_storage.h"
+#include "log.h"
 
 namespace oak {
 
+	namespace {
+		constexpr uint32_t SCENE_MAGIC = 0x534b414f; //OAKS
+		constexpr uint32_t SCENE_VERSION = 1;
+		constexpr size_t SCENE_HEADER_SIZE = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+		constexpr size_t BLOCK_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+
+		enum BlockTag : uint32_t {
+			ENTITY_BLOCK,
+			COMPONENT_BLOCK
+		};
+
+		enum ComponentEncoding : uint32_t {
+			RAW, //the components bytes
+			PUPED //the component written with a stream puper
+		};
+
+		void beginBlock(ByteBuffer& block, BlockTag tag) {
+			block.rewind();
+			Stream stream{ &block };
+			stream.write<uint32_t>(tag);
+			stream.write<uint64_t>(0);
+		}
+
+		//patches the block size into the header and writes the whole block at once
+		void endBlock(ByteBuffer& block, Stream& file) {
+			uint64_t size = block.pos() - BLOCK_HEADER_SIZE;
+			memcpy(block.data() + sizeof(uint32_t), &size, sizeof(size));
+			file.buffer->write(block.pos(), block.data());
+		}
+	}
+
 	EntityId Scene::createEntity() {
 		EntityId id;
 		if (freeIndices_.empty()) {
@@ -56,6 +92,11 @@ namespace oak {
 
 	void* Scene::addComponent(EntityId entity, size_t tid) {
 		auto& mask = componentMasks_[entity];
+		if (archetypes_ != nullptr) {
+			auto comp = makeArchetypeComponent(entity, tid);
+			ComponentTypeManager::inst().getTypeInfo(tid)->construct(comp);
+			return comp;
+		}
 		auto pool = componentPools_[tid];
 		if (mask[tid]) {
 			pool->removeComponent(entity);
@@ -66,6 +107,11 @@ namespace oak {
 
 	void Scene::addComponent(EntityId entity, size_t tid, const void *ptr) {
 		auto& mask = componentMasks_[entity];
+		if (archetypes_ != nullptr) {
+			auto comp = makeArchetypeComponent(entity, tid);
+			ComponentTypeManager::inst().getTypeInfo(tid)->copyConstruct(comp, ptr);
+			return;
+		}
 		auto pool = componentPools_[tid];
 		if (mask[tid]) {
 			pool->removeComponent(entity);
@@ -76,6 +122,10 @@ namespace oak {
 
 	void Scene::removeComponent(EntityId entity, size_t tid) {
 		componentMasks_[entity][tid] = false;
+		if (archetypes_ != nullptr) {
+			archetypes_->setMask(entity, componentMasks_[entity]);
+			return;
+		}
 		componentPools_[tid]->removeComponent(entity);
 	}
 
@@ -95,11 +145,15 @@ namespace oak {
 		return componentMasks_[entity];
 	}
 
-	void Scene::init() {
+	void Scene::init(StorageMode mode) {
+		if (mode == StorageMode::ARCHETYPE) {
+			archetypes_ = static_cast<ArchetypeStorage*>(oalloc_tagged(MemoryTag::SCENE)->allocate(sizeof(ArchetypeStorage)));
+			new (archetypes_) ArchetypeStorage{};
+		}
 		//create component storages for types in ComponentTypeManager
 		for (auto it : ComponentTypeManager::inst().getTypes()) {
-			auto ptr = static_cast<ComponentStorage*>(oak_allocator.allocate(sizeof(ComponentStorage)));
-			new (ptr) ComponentStorage(it);
+			auto ptr = static_cast<ComponentStorage*>(oalloc_tagged(MemoryTag::SCENE)->allocate(sizeof(ComponentStorage)));
+			new (ptr) ComponentStorage(it, mode, archetypes_);
 			ownsPools_.push_back(ptr);
 			addComponentStorage(ptr);
 		}
@@ -109,9 +163,14 @@ namespace oak {
 		reset();
 		for (auto it : ownsPools_) {
 			it->~ComponentStorage();
-			oak_allocator.deallocate(it, sizeof(ComponentStorage));
+			oalloc_tagged(MemoryTag::SCENE)->deallocate(it, sizeof(ComponentStorage));
 		}
 		ownsPools_.clear();
+		if (archetypes_ != nullptr) {
+			archetypes_->~ArchetypeStorage();
+			oalloc_tagged(MemoryTag::SCENE)->deallocate(archetypes_, sizeof(ArchetypeStorage));
+			archetypes_ = nullptr;
+		}
 	}
 
 	void Scene::update() {
@@ -125,6 +184,8 @@ namespace oak {
 
 
 		killed_.clear();
+
+		queries_.update(*this);
 	}
 
 	void Scene::reset() {
@@ -138,13 +199,225 @@ namespace oak {
 		for (auto& a : flags_) {
 			a.reset();
 		}
+		queries_.clear();
 		entities_.clear();
 		generations_.clear();
 		freeIndices_.clear();
+		trim();
+	}
+
+	void Scene::trim() {
+		for (auto storage : ownsPools_) {
+			storage->trim();
+		}
+		if (archetypes_ != nullptr) {
+			archetypes_->trim();
+		}
 	}
 
 	void Scene::save(const oak::string& path) {
 		auto file = FileManager::inst().openFile(path, true);
+
+		//header:
+		//magic
+		//version
+		//entity count
+		//block count
+		//blocks:
+		//	tag
+		//	size
+		//	entity block:
+		//		for each entity:
+		//			active
+		//	component block:
+		//		type name
+		//		type size
+		//		schema hash
+		//		encoding
+		//		component count
+		//		entity index of each component
+		//		component data
+
+		const auto& types = ComponentTypeManager::inst().getTypes();
+		const uint64_t entityCount = entities_.size();
+		uint64_t blockCount = 1;
+		for (const auto ti : types) {
+			if (ti == nullptr) { continue; }
+			for (const auto& entity : entities_) {
+				if (componentMasks_[entity][ti->id]) {
+					blockCount++;
+					break;
+				}
+			}
+		}
+
+		ByteBuffer block{ 4096, oalloc_tagged(MemoryTag::SCENE) };
+		Stream stream{ &block };
+		StreamPuper puper{ &stream };
+		auto info = ObjInfo::make<Scene>(nullptr, "scene");
+
+		block.rewind();
+		stream.write<uint32_t>(SCENE_MAGIC);
+		stream.write<uint32_t>(SCENE_VERSION);
+		stream.write<uint64_t>(entityCount);
+		stream.write<uint64_t>(blockCount);
+		file.buffer->write(block.pos(), block.data());
+
+		beginBlock(block, ENTITY_BLOCK);
+		for (const auto& entity : entities_) {
+			stream.write<uint8_t>(isEntityActive(entity) ? 1 : 0);
+		}
+		endBlock(block, file);
+
+		for (const auto ti : types) {
+			if (ti == nullptr) { continue; }
+			ScopedArena scratch;
+			oak::vector<uint32_t> indices{ scratch.allocator<uint32_t>() };
+			for (size_t i = 0; i < entities_.size(); i++) {
+				if (componentMasks_[entities_[i]][ti->id]) {
+					indices.push_back(static_cast<uint32_t>(i));
+				}
+			}
+			if (indices.empty()) { continue; }
+
+			const auto schema = makeTypeSchema(*ti);
+			beginBlock(block, COMPONENT_BLOCK);
+			stream.write(ti->name);
+			stream.write<uint64_t>(ti->size);
+			stream.write<uint64_t>(schema.hash);
+			stream.write<uint32_t>(schema.raw ? RAW : PUPED);
+			stream.write<uint64_t>(indices.size());
+			block.write(indices.size() * sizeof(uint32_t), indices.data());
+			if (schema.raw) {
+				for (auto index : indices) {
+					block.write(ti->size, getComponent(entities_[index], ti->id));
+				}
+			} else {
+				for (auto index : indices) {
+					ti->serialize(puper, getComponent(entities_[index], ti->id), info, ti->name);
+				}
+			}
+			endBlock(block, file);
+		}
+
+		FileManager::inst().closeFile(file);
+	}
+
+	void Scene::load(const oak::string& path) {
+		//the blocks are parsed straight out of the mapped file
+		auto map = FileManager::inst().mapFile(path);
+		Stream file{ &map };
+
+		if (map.size() < SCENE_HEADER_SIZE || file.read<uint32_t>() != SCENE_MAGIC) {
+			loadStream(path);
+			return;
+		}
+
+		const uint32_t version = file.read<uint32_t>();
+		if (version != SCENE_VERSION) {
+			log_print_warn("unsupported scene file version %u: %s", version, path.c_str());
+			return;
+		}
+		const uint64_t entityCount = file.read<uint64_t>();
+		const uint64_t blockCount = file.read<uint64_t>();
+		//every entity has a byte in the entity block
+		if (entityCount > map.size()) {
+			log_print_warn("corrupt scene file, %lu entities: %s", entityCount, path.c_str());
+			return;
+		}
+
+		reset();
+
+		ScopedArena scratch;
+		oak::vector<EntityId> entities{ scratch.allocator<EntityId>() };
+		oak::vector<uint8_t> active{ scratch.allocator<uint8_t>() };
+		entities.reserve(entityCount);
+		for (size_t i = 0; i < entityCount; i++) {
+			entities.push_back(createEntity());
+		}
+
+		auto info = ObjInfo::make<Scene>(nullptr, "scene");
+		oak::vector<uint32_t> indices{ scratch.allocator<uint32_t>() };
+
+		for (size_t b = 0; b < blockCount; b++) {
+			const uint32_t tag = file.read<uint32_t>();
+			const uint64_t size = file.read<uint64_t>();
+			const char *body = map.take(size);
+			if (body == nullptr) {
+				log_print_warn("truncated scene file: %s", path.c_str());
+				break;
+			}
+
+			//the view is only read from so it can wrap the read only mapping
+			ByteBuffer view{ const_cast<char*>(body), size };
+			Stream stream{ &view };
+
+			if (tag == ENTITY_BLOCK) {
+				if (size < entityCount) {
+					log_print_warn("truncated entity block in scene file: %s", path.c_str());
+					continue;
+				}
+				active.resize(entityCount);
+				view.read(entityCount, active.data());
+				continue;
+			}
+			if (tag != COMPONENT_BLOCK) { continue; }
+
+			const auto name = stream.read<oak::string>();
+			const uint64_t typeSize = stream.read<uint64_t>();
+			const uint64_t hash = stream.read<uint64_t>();
+			const uint32_t encoding = stream.read<uint32_t>();
+			const uint64_t count = stream.read<uint64_t>();
+
+			const auto ti = ComponentTypeManager::inst().getTypeInfo(name);
+			if (ti == nullptr) {
+				log_print_warn("unknown component type in scene file: %s", name.c_str());
+				continue;
+			}
+			if (encoding != RAW && encoding != PUPED) {
+				log_print_warn("unknown component encoding in scene file: %s", name.c_str());
+				continue;
+			}
+			if (ti->size != typeSize || makeTypeSchema(*ti).hash != hash) {
+				log_print_warn("component layout changed since the scene was saved: %s", name.c_str());
+				continue;
+			}
+
+			//the indices and raw components must fit in what is left of the block, puped components are at least a byte
+			const size_t left = view.pos() <= size ? size - view.pos() : 0;
+			const size_t perComponent = sizeof(uint32_t) + (encoding == RAW ? ti->size : 1);
+			if (count > left / perComponent) {
+				log_print_warn("truncated component block in scene file: %s", name.c_str());
+				continue;
+			}
+			indices.resize(count);
+			view.read(count * sizeof(uint32_t), indices.data());
+			if (std::any_of(std::begin(indices), std::end(indices), [entityCount](uint32_t index) { return index >= entityCount; })) {
+				log_print_warn("component block references a missing entity: %s", name.c_str());
+				continue;
+			}
+			if (encoding == RAW) {
+				for (auto index : indices) {
+					view.read(ti->size, addComponent(entities[index], ti->id));
+				}
+			} else {
+				StreamPuper puper{ &stream };
+				puper.setIo(PuperIo::IN);
+				for (auto index : indices) {
+					ti->serialize(puper, addComponent(entities[index], ti->id), info, ti->name);
+				}
+			}
+		}
+
+		for (size_t i = 0; i < active.size(); i++) {
+			if (active[i]) {
+				activateEntity(entities[i]);
+			}
+		}
+	}
+
+	void Scene::saveStream(const oak::string& path) {
+		auto file = FileManager::inst().openFile(path, true);
 		
 		auto info = ObjInfo::make<Scene>(nullptr, "scene");
 
@@ -172,10 +445,15 @@ namespace oak {
 
 		size_t i = 0;
 		for (auto& entity : entities_) {
+			//the names are rebuilt for every entity so they are released with each iteration
+			ScopedArena scratch;
 			auto& filter = getComponentFilter(entity);
 			auto active = isEntityActive(entity);
 			auto componentCount = filter.count();
-			auto entityInfo = ObjInfo::make<EntityId>(&info, oak::string{ "entity[" } + std::to_string(i).c_str() + "]");
+			oak::string name{ "entity[", scratch.allocator<char>() };
+			name += std::to_string(i).c_str();
+			name += "]";
+			auto entityInfo = ObjInfo::make<EntityId>(&info, name);
 			pup(puper, active, ObjInfo::make<size_t>(&entityInfo, "active"));
 			pup(puper, componentCount, ObjInfo::make<size_t>(&entityInfo, "componentCount"));
 			for (size_t j = 0; j < config::MAX_COMPONENTS; j++) {
@@ -191,7 +469,7 @@ namespace oak {
 		FileManager::inst().closeFile(file);
 	}
 
-	void Scene::load(const oak::string& path) {
+	void Scene::loadStream(const oak::string& path) {
 		reset();
 
 		auto file = FileManager::inst().openFile(path);
@@ -246,6 +524,19 @@ namespace oak {
 		return *componentPools_[tid];
 	}
 
+	void* Scene::makeArchetypeComponent(EntityId entity, size_t tid) {
+		auto& mask = componentMasks_[entity];
+		if (mask[tid]) {
+			//replace the existing component in place
+			auto comp = archetypes_->getComponent(entity, tid);
+			ComponentTypeManager::inst().getTypeInfo(tid)->destruct(comp);
+			return comp;
+		}
+		mask[tid] = true;
+		archetypes_->setMask(entity, mask);
+		return archetypes_->getComponent(entity, tid);
+	}
+
 	void Scene::ensureSize(size_t size) {
 		if (componentMasks_.size() <= size) {
 			componentMasks_.resize(size + 1);
@@ -256,6 +547,11 @@ namespace oak {
 	}
 
 	void Scene::removeAllComponents(EntityId entity) {
+		if (archetypes_ != nullptr) {
+			archetypes_->removeEntity(entity);
+			componentMasks_[entity].reset();
+			return;
+		}
 		for (size_t i = 0; i < config::MAX_COMPONENTS; i++) {
 			if (componentMasks_[entity][i]) {
 				removeComponent(entity, i);
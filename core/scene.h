@@ -5,6 +5,7 @@
 #include "container.h"
 #include "component.h"
 #include "entity_id.h"
+#include "entity_cache.h"
 
 namespace oak {
 	
@@ -13,6 +14,7 @@ namespace oak {
 	}
 
 	class ComponentStorage;
+	class ArchetypeStorage;
 
 	class Scene {
 	public:
@@ -33,19 +35,43 @@ namespace oak {
 		bool hasComponent(EntityId entity, size_t tid) const;
 		const std::bitset<config::MAX_COMPONENTS>& getComponentFilter(EntityId entity) const;
 
-		void init();
+		void init(StorageMode mode = StorageMode::POOL);
 		void terminate();
 
+		//destroys the entities killed since the last update and brings the queries up to date with the activate and deactivate events
+		//must be called once a frame after the systems have run and before the events are cleared
+		//systems see the same query contents for a whole frame, activations made during a frame show up in the queries the next frame
 		void update();
 		void reset();
+		//returns the pages of removed components to the allocators, reset trims the scene
+		void trim();
 
+		//binary scene files, components are stored in one block per type
 		void save(const oak::string& path);
+		//falls back to loadStream for scene files without the binary header
 		void load(const oak::string& path);
+		//per entity puper scene files
+		void saveStream(const oak::string& path);
+		void loadStream(const oak::string& path);
 
 		void addComponentStorage(ComponentStorage *storage);
 		ComponentStorage& getComponentStorage(size_t tid);
 		const ComponentStorage& getComponentStorage(size_t tid) const;
 
+		//only valid when the scene was initialized with StorageMode::ARCHETYPE
+		inline ArchetypeStorage* getArchetypes() { return archetypes_; }
+		inline const ArchetypeStorage* getArchetypes() const { return archetypes_; }
+
+		//shared entity caches, every query is updated once in update
+		inline const EntityCache& getQuery(const std::bitset<config::MAX_COMPONENTS>& componentFilter, size_t prefabFilter = 0) {
+			return queries_.get(*this, componentFilter, prefabFilter);
+		}
+
+		template<class... T>
+		const EntityCache& getQuery(size_t prefabFilter = 0) {
+			return queries_.get<T...>(*this, prefabFilter);
+		}
+
 		inline const oak::vector<EntityId>& getEntities() const { return entities_; }
 		inline size_t getEntityCount() const { return entities_.size(); }
 	private:
@@ -62,9 +88,13 @@ namespace oak {
 
 		oak::vector<ComponentStorage*> componentPools_;
 		oak::vector<ComponentStorage*> ownsPools_;
+		ArchetypeStorage *archetypes_ = nullptr;
+		QueryRegistry queries_;
 		
 		void ensureSize(size_t size);
 		void removeAllComponents(EntityId entity);
+		//returns uninitialized memory for the component in the entities archetype
+		void* makeArchetypeComponent(EntityId entity, size_t tid);
 	};
 
 }
@@ -2,6 +2,16 @@
 
 namespace oak {
 
+	bool SystemAccess::conflicts(const SystemAccess& other, const std::bitset<config::MAX_EVENTS>& doubleBuffered) const {
+		if (!declared || !other.declared) { return true; }
+		//two systems conflict if one writes data the other reads or writes
+		return (writeComponents & (other.readComponents | other.writeComponents)).any() ||
+			(other.writeComponents & readComponents).any() ||
+			(writeEvents & other.writeEvents).any() ||
+			(writeEvents & other.readEvents & ~doubleBuffered).any() ||
+			(other.writeEvents & readEvents & ~doubleBuffered).any();
+	}
+
 	System::~System() {}
 
 	void System::init() {
@@ -1,7 +1,25 @@
 #pragma once
 
+#include <bitset>
+
+#include "component.h"
+#include "event.h"
+
 namespace oak {
 
+	//the component types and event queues a system touches while running
+	struct SystemAccess {
+		std::bitset<config::MAX_COMPONENTS> readComponents;
+		std::bitset<config::MAX_COMPONENTS> writeComponents;
+		std::bitset<config::MAX_EVENTS> readEvents;
+		std::bitset<config::MAX_EVENTS> writeEvents;
+		//systems that never declare their access are assumed to touch everything
+		bool declared = false;
+
+		//producers and consumers of double buffered events touch different buffers so they do not conflict
+		bool conflicts(const SystemAccess& other, const std::bitset<config::MAX_EVENTS>& doubleBuffered = {}) const;
+	};
+
 	class System {
 	public:
 		virtual ~System();
@@ -10,6 +28,41 @@ namespace oak {
 		virtual void terminate();
 
 		virtual void run();
+
+		//systems that use thread bound resources (eg. the graphics context) must run on the main thread
+		inline bool isMainThread() const { return mainThread_; }
+		inline const SystemAccess& getAccess() const { return access_; }
+
+	protected:
+		bool mainThread_ = false;
+
+		//access declarations, should be made in init
+		template<class T>
+		void readComponent() {
+			access_.readComponents[T::typeInfo.id] = true;
+			access_.declared = true;
+		}
+
+		template<class T>
+		void writeComponent() {
+			access_.writeComponents[T::typeInfo.id] = true;
+			access_.declared = true;
+		}
+
+		template<class T>
+		void consumeEvent() {
+			access_.readEvents[T::typeInfo.id] = true;
+			access_.declared = true;
+		}
+
+		template<class T>
+		void produceEvent() {
+			access_.writeEvents[T::typeInfo.id] = true;
+			access_.declared = true;
+		}
+
+	private:
+		SystemAccess access_;
 	};
 
 
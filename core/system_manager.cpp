@@ -1,5 +1,9 @@
 #include "system_manager.h"
 
+#include "job_manager.h"
+#include "event_manager.h"
+#include "log.h"
+
 namespace oak {
 
 	SystemManager *SystemManager::instance = nullptr;
@@ -16,14 +20,33 @@ namespace oak {
 
 	void SystemManager::addSystem(System *system, size_t id) {
 		systems_.insert({ id, system });
+		nodes_.push_back({ system, id, {}, {}, nullptr });
 		system->init();
+		dirty_ = true;
 	}
 
 	void SystemManager::removeSystem(size_t id) {
 		const auto& it = systems_.find(id);
 		if (it != std::end(systems_)) {
 			systems_.erase(it);
-		}	
+		}
+		for (auto nit = std::begin(nodes_); nit != std::end(nodes_); ++nit) {
+			if (nit->id == id) {
+				nodes_.erase(nit);
+				break;
+			}
+		}
+		dirty_ = true;
+	}
+
+	void SystemManager::addDependency(size_t id, size_t dependsOn) {
+		for (auto& node : nodes_) {
+			if (node.id == id) {
+				node.dependencies.push_back(dependsOn);
+				dirty_ = true;
+				return;
+			}
+		}
 	}
 
 	System* SystemManager::getSystem(size_t id) {
@@ -40,12 +63,129 @@ namespace oak {
 		return it != std::end(systems_);
 	}
 
+	void SystemManager::run() {
+		auto& jobManager = JobManager::inst();
+
+		if (dirty_) {
+			buildGraph();
+		}
+
+		//create a job for each system and group them under a single root job
+		Job *root = jobManager.create(nullptr);
+		for (auto& node : nodes_) {
+			System *system = node.system;
+			node.job = jobManager.create([system]() {
+				system->run();
+				//make events emitted from worker threads visible to the systems that run after this one
+				//a system has exclusive access to the events it produces so only it can be appending to them
+				const auto& access = system->getAccess();
+				if (access.declared) {
+					EventManager::inst().flush(access.writeEvents);
+				} else {
+					EventManager::inst().flush();
+				}
+			}, root, system->isMainThread() ? Job::MAIN_THREAD : 0);
+		}
+
+		//a system job is a continuation of every system it depends on
+		for (auto& node : nodes_) {
+			for (auto index : node.after) {
+				jobManager.addContinuation(nodes_[index].job, node.job);
+			}
+		}
+
+		for (auto& node : nodes_) {
+			jobManager.run(node.job);
+		}
+		jobManager.run(root);
+		jobManager.wait(root);
+	}
+
+	void SystemManager::buildGraph() {
+		const size_t count = nodes_.size();
+		const auto& doubleBuffered = EventManager::inst().getDoubleBuffered();
+
+		auto findNode = [&](size_t id) {
+			for (size_t j = 0; j < count; j++) {
+				if (nodes_[j].id == id) { return j; }
+			}
+			return count;
+		};
+
+		//order the systems so that every system comes after its explicit dependencies, otherwise keep the order they were added in
+		oak::vector<size_t> order;
+		oak::vector<bool> placed(count, false);
+		while (order.size() < count) {
+			size_t next = count;
+			for (size_t i = 0; i < count && next == count; i++) {
+				if (placed[i]) { continue; }
+				bool ready = true;
+				for (auto id : nodes_[i].dependencies) {
+					const size_t j = findNode(id);
+					if (j != count && j != i && !placed[j]) {
+						ready = false;
+						break;
+					}
+				}
+				if (ready) { next = i; }
+			}
+			if (next == count) {
+				//every remaining system waits on another, break the cycle at the oldest one and ignore its remaining dependencies
+				for (next = 0; placed[next]; next++);
+				log_print_err("system dependency cycle through system: %lu", nodes_[next].id);
+			}
+			placed[next] = true;
+			order.push_back(next);
+		}
+
+		//reachable[i * count + j] is true if node j is known to finish before node i runs
+		//edges only go forward in the order so a nodes reachable set is complete before anything depends on it
+		oak::vector<bool> reachable(count * count, false);
+		auto addEdge = [&](size_t from, size_t to) {
+			nodes_[to].after.push_back(from);
+			reachable[to * count + from] = true;
+			for (size_t k = 0; k < count; k++) {
+				if (reachable[from * count + k]) {
+					reachable[to * count + k] = true;
+				}
+			}
+		};
+
+		placed.assign(count, false);
+		for (size_t p = 0; p < count; p++) {
+			const size_t i = order[p];
+			auto& node = nodes_[i];
+			node.after.clear();
+			//explicit dependencies, a dependency that is not placed yet was part of a cycle
+			for (auto id : node.dependencies) {
+				const size_t j = findNode(id);
+				if (j != count && j != i && placed[j] && !reachable[i * count + j]) {
+					addEdge(j, i);
+				}
+			}
+			//conflicting systems run in this order, check the most recent systems first
+			//so that older conflicts are usually already covered by a path through the graph
+			const auto& access = node.system->getAccess();
+			for (size_t q = p; q-- > 0;) {
+				const size_t j = order[q];
+				if (!reachable[i * count + j] && access.conflicts(nodes_[j].system->getAccess(), doubleBuffered)) {
+					addEdge(j, i);
+				}
+			}
+			placed[i] = true;
+		}
+
+		dirty_ = false;
+	}
+
 	void SystemManager::clear() {
 		//terminate systems
 		for (auto system : systems_) {
 			system.second->terminate();
 		}
 		systems_.clear();
+		nodes_.clear();
+		dirty_ = true;
 	}
 
 }
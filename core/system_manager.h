@@ -8,6 +8,8 @@
 
 namespace oak {
 
+	struct Job;
+
 	class SystemManager {
 	private:
 		static SystemManager *instance;
@@ -22,14 +24,35 @@ namespace oak {
 
 		void addSystem(System *system, size_t id);
 		void removeSystem(size_t id);
+		//system id will not run until the system dependsOn has finished running
+		void addDependency(size_t id, size_t dependsOn);
 
 		System* getSystem(size_t id);
 		bool hasSystem(size_t id);
 
+		//runs every system as a job on the job manager and waits for them to finish
+		//systems whose declared access conflicts run in the order they were added unless an explicit dependency orders them
+		//the rest run concurrently
+		void run();
+
 		void clear();
 
 	private:
-		oak::unordered_map<size_t, System*> systems_;
+		struct SystemNode {
+			System *system;
+			size_t id;
+			oak::vector<size_t> dependencies;
+			//indices of the nodes that must finish before this one runs
+			oak::vector<size_t> after;
+			Job *job;
+		};
+
+		oak::hash_map<size_t, System*> systems_;
+		//systems in the order they were added
+		oak::vector<SystemNode> nodes_;
+		bool dirty_ = true;
+
+		void buildGraph();
 	};
 
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <utility>
+#include <type_traits>
+
 #include "util/type_id.h"
 #include "container.h"
 #include "pup.h"
@@ -25,6 +28,11 @@ namespace oak {
 			new (object) T{ *static_cast<const T*>(src) };
 		}
 
+		template<class T>
+		void moveConstruct(void *object, void *src) {
+			new (object) T{ std::move(*static_cast<T*>(src)) };
+		}
+
 		template<class T>
 		void copy(void *object, const void *src) {
 			*static_cast<T*>(object) = *static_cast<const T*>(src);
@@ -52,9 +60,12 @@ namespace oak {
 		oak::string name;
 		size_t size;
 		size_t id;
+		//the type can be copied with memcpy
+		bool trivial;
 		
 		void (*construct)(void *object);
 		void (*copyConstruct)(void *object, const void *src);
+		void (*moveConstruct)(void *object, void *src);
 		void (*copy)(void *object, const void *src);
 		void (*destroy)(void *object);
 		void (*destruct)(void *object);
@@ -67,8 +78,10 @@ namespace oak {
 			name,
 			sizeof(T),
 			util::type_id<U, T>::id(),
+			std::is_trivially_copyable<T>::value,
 			detail::construct<T>,
 			detail::copyConstruct<T>,
+			detail::moveConstruct<T>,
 			detail::copy<T>,
 			detail::destroy<T>,
 			detail::destruct<T>,
@@ -58,7 +58,7 @@ namespace oak {
 
 	private:
 		oak::vector<const TypeInfo*> types_;
-		oak::unordered_map<oak::string, size_t> nameMap_;
+		oak::hash_map<oak::string, size_t> nameMap_;
 	};
 
 
@@ -76,7 +76,11 @@ namespace oak {
 
 	void ByteBuffer::checkResize(size_t size) {
 		if (pos_ + size > capacity_) {
-			resize(capacity_ * 2);
+			size_t capacity = capacity_ == 0 ? 64 : capacity_;
+			while (pos_ + size > capacity) {
+				capacity *= 2;
+			}
+			resize(capacity);
 		}
 	}
 
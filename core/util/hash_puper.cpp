@@ -0,0 +1,85 @@
+#include "hash_puper.h"
+
+#include "type_info.h"
+#include "oak_alloc.h"
+
+namespace oak {
+
+	namespace {
+		enum Kind : uint32_t {
+			INT,
+			UINT,
+			FLOAT,
+			BOOL,
+			POINTER,
+			STRING
+		};
+
+		constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+		constexpr uint64_t FNV_PRIME = 1099511628211ull;
+	}
+
+	HashPuper::HashPuper(const void *object, size_t size) : object_{ object }, size_{ size }, hash_{ FNV_OFFSET } {
+		add(&size_, sizeof(size_));
+	}
+
+	void HashPuper::pup(int8_t& data, const ObjInfo& info) { add(INT, sizeof(data), &data, info); }
+	void HashPuper::pup(int16_t& data, const ObjInfo& info) { add(INT, sizeof(data), &data, info); }
+	void HashPuper::pup(int32_t& data, const ObjInfo& info) { add(INT, sizeof(data), &data, info); }
+	void HashPuper::pup(int64_t& data, const ObjInfo& info) { add(INT, sizeof(data), &data, info); }
+	void HashPuper::pup(uint8_t& data, const ObjInfo& info) { add(UINT, sizeof(data), &data, info); }
+	void HashPuper::pup(uint16_t& data, const ObjInfo& info) { add(UINT, sizeof(data), &data, info); }
+	void HashPuper::pup(uint32_t& data, const ObjInfo& info) { add(UINT, sizeof(data), &data, info); }
+	void HashPuper::pup(uint64_t& data, const ObjInfo& info) { add(UINT, sizeof(data), &data, info); }
+	void HashPuper::pup(float& data, const ObjInfo& info) { add(FLOAT, sizeof(data), &data, info); }
+	void HashPuper::pup(double& data, const ObjInfo& info) { add(FLOAT, sizeof(data), &data, info); }
+	void HashPuper::pup(bool& data, const ObjInfo& info) { add(BOOL, sizeof(data), &data, info); }
+
+	void HashPuper::pup(void*& data, const ObjInfo& info) {
+		volatile_ = true;
+		add(POINTER, sizeof(data), &data, info);
+	}
+
+	void HashPuper::pup(oak::string& data, const ObjInfo& info) {
+		add(STRING, sizeof(data), &data, info);
+	}
+
+	void HashPuper::add(uint32_t kind, size_t fieldSize, const void *data, const ObjInfo& info) {
+		if (info.flags & ObjInfo::VOLATILE) {
+			volatile_ = true;
+		}
+		//fields outside of the object (eg. in a heap allocation it owns) have no offset
+		const auto begin = static_cast<const char*>(object_);
+		const auto field = static_cast<const char*>(data);
+		uint64_t offset = field >= begin && field < begin + size_ ? static_cast<uint64_t>(field - begin) : ~uint64_t{ 0 };
+		uint64_t size = fieldSize;
+
+		add(&kind, sizeof(kind));
+		add(&size, sizeof(size));
+		add(&offset, sizeof(offset));
+		add(info.name.data(), info.name.size());
+	}
+
+	void HashPuper::add(const void *data, size_t size) {
+		const auto bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash_ = (hash_ ^ bytes[i]) * FNV_PRIME;
+		}
+	}
+
+	TypeSchema makeTypeSchema(const TypeInfo& typeInfo) {
+		//the fields are visited on a default constructed instance
+		ScopedArena scratch;
+		void *object = scratch.allocate(typeInfo.size);
+		typeInfo.construct(object);
+
+		HashPuper puper{ object, typeInfo.size };
+		auto info = ObjInfo::make<TypeInfo>(nullptr, typeInfo.name);
+		puper.add(typeInfo.name.data(), typeInfo.name.size());
+		typeInfo.serialize(puper, object, info, typeInfo.name);
+
+		typeInfo.destruct(object);
+		return { puper.getHash(), typeInfo.trivial && !puper.hasVolatile() };
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "util/puper.h"
+
+namespace oak {
+
+	struct TypeInfo;
+
+	//hashes the layout of an object instead of its values, the kind, name and offset of every field that is visited
+	//two objects with the same hash can be copied between each other byte for byte
+	class HashPuper : public Puper {
+	public:
+		HashPuper(const void *object, size_t size);
+
+		void pup(int8_t& data, const ObjInfo& info) override;
+		void pup(int16_t& data, const ObjInfo& info) override;
+		void pup(int32_t& data, const ObjInfo& info) override;
+		void pup(int64_t& data, const ObjInfo& info) override;
+		void pup(uint8_t& data, const ObjInfo& info) override;
+		void pup(uint16_t& data, const ObjInfo& info) override;
+		void pup(uint32_t& data, const ObjInfo& info) override;
+		void pup(uint64_t& data, const ObjInfo& info) override;
+		void pup(float& data, const ObjInfo& info) override;
+		void pup(double& data, const ObjInfo& info) override;
+		void pup(bool& data, const ObjInfo& info) override;
+		void pup(void*& data, const ObjInfo& info) override;
+		void pup(oak::string& data, const ObjInfo& info) override;
+
+		inline uint64_t getHash() const { return hash_; }
+		//true if a visited field is only meaningful in this process (eg. a pointer)
+		inline bool hasVolatile() const { return volatile_; }
+
+		//mixes raw bytes into the hash
+		void add(const void *data, size_t size);
+
+	private:
+		const void *object_;
+		size_t size_;
+		uint64_t hash_;
+		bool volatile_ = false;
+
+		void add(uint32_t kind, size_t fieldSize, const void *data, const ObjInfo& info);
+	};
+
+	struct TypeSchema {
+		uint64_t hash;
+		//the type can be saved and loaded as its bytes
+		bool raw;
+	};
+
+	//hashes the name, size and fields of a type, the hash changes when the layout of the type changes
+	TypeSchema makeTypeSchema(const TypeInfo& typeInfo);
+
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "mapped_buffer.h"
+
+#include <cstring>
+#include <utility>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace oak {
+
+	MappedBuffer::MappedBuffer(const char *path) {
+		int fd = open(path, O_RDONLY);
+		if (fd < 0) { return; }
+
+		struct stat st;
+		if (fstat(fd, &st) == 0) {
+			size_ = static_cast<size_t>(st.st_size);
+			if (size_ == 0) {
+				//empty files cannot be mapped
+				valid_ = true;
+			} else {
+				void *ptr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+				if (ptr != MAP_FAILED) {
+					data_ = static_cast<const char*>(ptr);
+					valid_ = true;
+				} else {
+					size_ = 0;
+				}
+			}
+		}
+		//the mapping keeps the file alive
+		close(fd);
+	}
+
+	MappedBuffer::~MappedBuffer() {
+		destroy();
+	}
+
+	MappedBuffer::MappedBuffer(MappedBuffer&& other) {
+		*this = std::move(other);
+	}
+
+	void MappedBuffer::operator=(MappedBuffer&& other) {
+		destroy();
+		data_ = other.data_;
+		size_ = other.size_;
+		pos_ = other.pos_;
+		mark_ = other.mark_;
+		valid_ = other.valid_;
+
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.pos_ = 0;
+		other.mark_ = 0;
+		other.valid_ = false;
+	}
+
+	void MappedBuffer::set() {
+		mark_ = pos_;
+	}
+
+	void MappedBuffer::reset() {
+		pos_ = mark_;
+		mark_ = 0;
+	}
+
+	void MappedBuffer::rewind() {
+		pos_ = 0;
+	}
+
+	size_t MappedBuffer::read(size_t size, void *data) {
+		if (pos_ + size > size_) {
+			size = size_ - pos_;
+		}
+		if (size == 0) { return 0; }
+		memcpy(data, data_ + pos_, size);
+		pos_ += size;
+		return size;
+	}
+
+	size_t MappedBuffer::write(size_t size, const void *data) {
+		return 0;
+	}
+
+	const char* MappedBuffer::take(size_t size) {
+		if (pos_ + size > size_) { return nullptr; }
+		const char *ptr = data_ + pos_;
+		pos_ += size;
+		return ptr;
+	}
+
+	void MappedBuffer::destroy() {
+		if (data_ != nullptr) {
+			munmap(const_cast<char*>(data_), size_);
+		}
+		data_ = nullptr;
+		size_ = 0;
+		pos_ = 0;
+		mark_ = 0;
+		valid_ = false;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+
+#include "stream.h"
+
+namespace oak {
+
+	//read only view of a memory mapped file, the pages are shared with the page cache and with
+	//every other process that maps the same file so large files can be parsed in place without a copy
+	class MappedBuffer : public BufferBase {
+	public:
+		MappedBuffer() = default;
+		explicit MappedBuffer(const char *path);
+		~MappedBuffer();
+
+		MappedBuffer(const MappedBuffer&) = delete;
+		void operator=(const MappedBuffer&) = delete;
+
+		MappedBuffer(MappedBuffer&& other);
+		void operator=(MappedBuffer&& other);
+
+		void set() override;
+		void reset() override;
+		void rewind() override;
+
+		size_t read(size_t size, void *data) override;
+		//the mapping is read only, writes do nothing
+		size_t write(size_t size, const void *data) override;
+
+		//returns the next size bytes in place and moves past them, nullptr if there are not enough bytes left
+		const char* take(size_t size);
+
+		inline size_t size() const override { return size_; }
+		inline size_t pos() const { return pos_; }
+		inline const char* data() const { return data_; }
+		inline bool isValid() const { return valid_; }
+	private:
+		const char *data_ = nullptr;
+		size_t size_ = 0;
+		size_t pos_ = 0;
+		size_t mark_ = 0;
+		bool valid_ = false;
+
+		void destroy();
+	};
+
+}
\ No newline at end of file
@@ -6,7 +6,7 @@
 namespace oak::ptrutil {
 
 	constexpr inline size_t alignSize(size_t size, uint32_t alignment) {
-		return (size + alignment-1) & (~(alignment-1));
+		return (size + alignment-1) & ~static_cast<size_t>(alignment-1);
 	}
 
 	constexpr inline uint32_t alignForwardAdjustment(const void *address, uint32_t alignment) {
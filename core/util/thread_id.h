@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+
+#include "oak_assert.h"
+
+namespace oak {
+
+	namespace config {
+		constexpr size_t MAX_THREAD_SLOTS = 64;
+	}
+
+	namespace util {
+
+		namespace detail {
+			//claims the lowest free slot for the lifetime of the thread
+			struct ThreadSlot {
+				static inline std::atomic<uint64_t> used{ 0 };
+
+				size_t index;
+
+				ThreadSlot() {
+					uint64_t mask = used.load();
+					do {
+						oak_assert(~mask != 0);
+						index = __builtin_ctzll(~mask);
+					} while (!used.compare_exchange_weak(mask, mask | (uint64_t{ 1 } << index)));
+				}
+
+				~ThreadSlot() {
+					used.fetch_and(~(uint64_t{ 1 } << index));
+				}
+			};
+		}
+
+		//small dense index in [0, MAX_THREAD_SLOTS) that is unique among the running threads
+		//slots are reused once a thread exits
+		inline size_t threadSlot() {
+			thread_local detail::ThreadSlot slot;
+			return slot.index;
+		}
+
+	}
+
+}
@@ -4,11 +4,14 @@
 
 #include <graphics/gl_api.h>
 #include <resource_manager.h>
+#include <resource_reloader.h>
 #include <event_manager.h>
 #include <input_manager.h>
 #include <input_events.h>
+#include <scene_events.h>
 #include <scene_utils.h>
 #include <util/string_util.h>
+#include <oakengine.h>
 
 #include "components.h"
 
@@ -16,25 +19,56 @@ Console::Console(oak::Scene *scene) : scene_{ scene } {}
 
 
 void Console::init() {
+	writeComponent<TextComponent>();
+	consumeEvent<oak::TextEvent>();
+	consumeEvent<oak::KeyEvent>();
+
 	auto& shHandle = oak::ResourceManager::inst().get<oak::graphics::Shader>();
 	auto& texHandle = oak::ResourceManager::inst().get<oak::graphics::Texture>();
 	auto& matHandle = oak::ResourceManager::inst().get<oak::graphics::Material>();
 	auto& fontHandle = oak::ResourceManager::inst().get<oak::graphics::Font>();
 
 	//load font rendering stuffs
+	//the shader, atlas and glyphs are read on the loader threads, created on the main thread and loaded again when their files change
+	//the loads replace these empty resources in place so the material keeps pointing at the current shader and atlas,
+	//the text has no glyphs to draw until the font is published
+	auto& shader = shHandle.add("font", oak::graphics::Shader{});
+	auto& tex = texHandle.add("dejavu", oak::graphics::Texture{});
+	matHandle.add("dejavu", &shader, &tex);
+	fontHandle.add("dejavu", oak::graphics::Font{});
+
+	auto& reloader = oak::ResourceReloader::inst();
 	oak::graphics::ShaderInfo shaderInfo;
 	shaderInfo.vertex = "/res/shaders/font/vert.glsl";
 	shaderInfo.fragment = "/res/shaders/font/frag.glsl";
-	auto& shader = shHandle.add("font", oak::graphics::shader::create(shaderInfo));
-	oak::graphics::shader::bind(shader);
-	oak::graphics::shader::setUniform(shader, "text_width", 0.4f);
-	oak::graphics::shader::setUniform(shader, "text_edge", 0.4f);
-	oak::graphics::shader::setUniform(shader, "border_width", 0.1f);
-	oak::graphics::shader::setUniform(shader, "border_edge", 0.1f);
+	reloader.load<oak::graphics::Shader>("font", { shaderInfo.vertex, shaderInfo.fragment }, [shaderInfo]() {
+		return oak::graphics::shader::decode(shaderInfo);
+	}, [shaderInfo](oak::graphics::ShaderSource& source) {
+		auto shader = oak::graphics::shader::create(source, shaderInfo);
+		oak::graphics::shader::bind(shader);
+		oak::graphics::shader::setUniform(shader, "text_width", 0.4f);
+		oak::graphics::shader::setUniform(shader, "text_edge", 0.4f);
+		oak::graphics::shader::setUniform(shader, "border_width", 0.1f);
+		oak::graphics::shader::setUniform(shader, "border_edge", 0.1f);
+		return shader;
+	});
 	oak::graphics::TextureInfo texInfo;
-	auto& tex = texHandle.add("dejavu", oak::graphics::texture::create("/res/fonts/dejavu_sans/atlas.png", texInfo));
-	auto& material = matHandle.add("dejavu", &shader, &tex);
-	auto& font = fontHandle.add("dejavu", oak::graphics::loadFont("/res/fonts/dejavu_sans/glyphs.fnt"));
+	reloader.load<oak::graphics::Texture>("dejavu", { "/res/fonts/dejavu_sans/atlas.png" }, [texInfo]() {
+		return oak::graphics::texture::decode("/res/fonts/dejavu_sans/atlas.png", texInfo);
+	}, [texInfo](oak::graphics::Image& image) {
+		return oak::graphics::texture::create(image, texInfo);
+	});
+	reloader.load<oak::graphics::Font>("dejavu", { "/res/fonts/dejavu_sans/glyphs.fnt" }, []() {
+		return oak::graphics::loadFont("/res/fonts/dejavu_sans/glyphs.fnt");
+	});
+	//the material is rebuilt on the main thread after its shader or atlas has been reloaded
+	reloader.load<oak::graphics::Material>("dejavu", {}, []() { return 0; }, [](int&) {
+		return oak::graphics::Material{ &oak::requireResource<oak::graphics::Shader>("font"), { &oak::requireResource<oak::graphics::Texture>("dejavu") } };
+	});
+	reloader.addDependency<oak::graphics::Material, oak::graphics::Shader>("dejavu", "font");
+	reloader.addDependency<oak::graphics::Material, oak::graphics::Texture>("dejavu", "dejavu");
+	//the glyph regions are laid out on the atlas so the glyphs are read again when the atlas changes
+	reloader.addDependency<oak::graphics::Font, oak::graphics::Texture>("dejavu", "dejavu");
 
 	console_ = scene_->createEntity();
 	oak::addComponent<TransformComponent>(console_, *scene_, glm::translate(glm::scale(glm::mat3{ 1.0f }, glm::vec2{ 0.15f }), glm::vec2{ 128.0f, 16.0f }));
@@ -70,6 +104,36 @@ static const Command commands[] = {
 	{ "edit", edit }
 };
 
+void Console::update() {
+	//ESC toggles console, the activation flags are written here because update runs on the main thread
+	for (auto& evt : oak::EventManager::inst().getQueue<oak::KeyEvent>()) {
+		if (evt.action == oak::action::pressed && evt.key == oak::key::esc) {
+			if (scene_->isEntityActive(console_)) {
+				scene_->deactivateEntity(console_);
+			} else {
+				scene_->activateEntity(console_);
+			}
+		}
+	}
+
+	//typed characters should not trigger actions
+	if (scene_->isEntityActive(console_)) {
+		for (auto& evt : oak::EventManager::inst().getQueue<oak::TextEvent>()) {
+			oak::InputManager::inst().setKey(toupper(static_cast<char>(evt.codepoint)), oak::action::released);
+		}
+	}
+
+	if (!command_.empty()) {
+		for (auto& command : commands) {
+			if (strcmp(command_[1].c_str(), command.name) == 0) {
+				command.exec(command_, scene_);
+				break;
+			}
+		}
+		command_.clear();
+	}
+}
+
 void Console::run() {
 	auto& tc = oak::getComponent<TextComponent>(console_, *scene_);
 
@@ -78,9 +142,7 @@ void Console::run() {
 	//get character events 
 	if (isActive) {
 		for (auto& evt : oak::EventManager::inst().getQueue<oak::TextEvent>()) {
-			auto c = static_cast<char>(evt.codepoint);
-			tc.text.push_back(c);
-			oak::InputManager::inst().setKey(toupper(c), oak::action::released);
+			tc.text.push_back(static_cast<char>(evt.codepoint));
 		}
 	}
 
@@ -106,27 +168,12 @@ void Console::run() {
 			}
 		}
 		if (evt.action == oak::action::pressed) {
-			//ESC toggles console
-			if (evt.key == oak::key::esc) {
-				if (scene_->isEntityActive(console_)) {
-					scene_->deactivateEntity(console_);
-				} else {
-					scene_->activateEntity(console_);
-				}
-			}
 			if (isActive) {
 				
-				//ENTER runs command
+				//ENTER runs command at the start of the next frame
 				if (evt.key == oak::key::enter) {
-					oak::vector<oak::string> tokens;
-					oak::util::splitstr(tc.text, " ", tokens);
-					
-					for (auto& command : commands) {
-						if (strcmp(tokens[1].c_str(), command.name) == 0) {
-							command.exec(tokens, scene_);
-							break;
-						}
-					}
+					command_.clear();
+					oak::util::splitstr(tc.text, " ", command_);
 					
 					tc.text = "console: ";
 				}
@@ -10,8 +10,12 @@ public:
 	void init() override;
 	void terminate() override;
 	void run() override;
+	//toggles the console, releases the keys typed into it and runs the command entered last frame
+	//these touch the input manager and the whole scene so they are done on the main thread before the systems run
+	void update();
 
 private:
 	oak::Scene *scene_;
 	oak::EntityId console_;
+	oak::vector<oak::string> command_;
 };
\ No newline at end of file
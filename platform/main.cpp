@@ -13,7 +13,10 @@
 #include <log.h>
 #include <file_manager.h>
 #include <system_manager.h>
+#include <job_manager.h>
 #include <resource_manager.h>
+#include <resource_loader.h>
+#include <resource_reloader.h>
 #include <event_manager.h>
 #include <input_manager.h>
 #include <audio_manager.h>
@@ -24,6 +27,7 @@
 #include <update_events.h>
 #include <input.h>
 #include <prefab.h>
+#include <oakengine.h>
 #include <scene_utils.h>
 
 #include "render_system.h"
@@ -45,7 +49,7 @@ struct CollisionSystem : public oak::System {
 		auto& ts = oak::getComponentStorage<TransformComponent>(*scene);
 		auto& ms = oak::getComponentStorage<const MeshComponent>(*scene);
 
-		auto& entities = collisionCache.entities();
+		auto& entities = collisionCache->entities();
 
 		oak::Simplex splex{ &oak::oalloc_frame };
 		for (size_t i = 0; i < entities.size(); i++) {
@@ -77,7 +81,7 @@ struct CollisionSystem : public oak::System {
 		auto& vs = oak::getComponentStorage<VelocityComponent>(*scene);
 		auto& rbs = oak::getComponentStorage<const RigidBodyComponent>(*scene);
 		for (auto& manifold : manifolds_) {
-			if (!rigidBodyCache.contains(manifold.A) || !rigidBodyCache.contains(manifold.B)) { continue; }
+			if (!rigidBodyCache->contains(manifold.A) || !rigidBodyCache->contains(manifold.B)) { continue; }
 			//get components
 			auto [tcA, vcA, rbA] = oak::getComponents<TransformComponent, VelocityComponent, const RigidBodyComponent>(manifold.A, ts, vs, rbs);
 			auto [tcB, vcB, rbB] = oak::getComponents<TransformComponent, VelocityComponent, const RigidBodyComponent>(manifold.B, ts, vs, rbs);
@@ -115,17 +119,16 @@ struct CollisionSystem : public oak::System {
 			tcA.transform[2] -= glm::vec3{ rbA.invMass * correction, 0.0f };
 			tcB.transform[2] += glm::vec3{ rbB.invMass * correction, 0.0f };
 		}
-		//integrate velocity
-		for (auto& entity : rigidBodyCache.entities()) {
-			auto [tc, vc] = oak::getComponents<TransformComponent, VelocityComponent>(entity, ts, vs);
-			
+		//integrate velocity, every entity is independent so split the work across the job threads
+		const float dt = this->dt;
+		oak::parallelForEach<TransformComponent, VelocityComponent>(*rigidBodyCache, *scene, [dt](oak::EntityId, TransformComponent& tc, VelocityComponent& vc) {
 			tc.transform[2] += glm::vec3{ vc.velocity * dt + (0.5f * vc.acceleration * dt * dt), 0.0f };
 			vc.velocity += vc.acceleration * dt;	
-		}
+		});
 	}
 
 	void movePlayer() {
-		auto& vc = oak::getComponent<VelocityComponent>(playerCache.entities()[0], *scene);
+		auto& vc = oak::getComponent<VelocityComponent>(playerCache->entities()[0], *scene);
 		if (oak::InputManager::inst().getAction("move_up") == oak::action::pressed) {
 			vc.velocity.y -= 244.0f;
 			oak::InputManager::inst().setAction("move_up", oak::action::released);
@@ -141,27 +144,26 @@ struct CollisionSystem : public oak::System {
 	}
 
 	void init() override {
-		collisionCache.requireComponent<TransformComponent>();
-		collisionCache.requireComponent<MeshComponent>();
-		playerCache.requirePrefab(std::hash<oak::string>{}("player"));
-		rigidBodyCache.requireComponent<TransformComponent>();
-		rigidBodyCache.requireComponent<VelocityComponent>();
-		rigidBodyCache.requireComponent<RigidBodyComponent>();
+		writeComponent<TransformComponent>();
+		writeComponent<VelocityComponent>();
+		readComponent<MeshComponent>();
+		readComponent<RigidBodyComponent>();
+
+		collisionCache = &scene->getQuery<TransformComponent, MeshComponent>();
+		playerCache = &scene->getQuery<>(std::hash<oak::string>{}("player"));
+		rigidBodyCache = &scene->getQuery<TransformComponent, VelocityComponent, RigidBodyComponent>();
 	}
 
 	void run() override {
-		collisionCache.update(*scene);
-		playerCache.update(*scene);
-		rigidBodyCache.update(*scene);
 		movePlayer();
 		doCollision();
 		doPhysics();
 		manifolds_.clear();
 	}
 
-	oak::EntityCache collisionCache;
-	oak::EntityCache playerCache;
-	oak::EntityCache rigidBodyCache;
+	const oak::EntityCache *collisionCache;
+	const oak::EntityCache *playerCache;
+	const oak::EntityCache *rigidBodyCache;
 	oak::Scene *scene;
 	oak::vector<Manifold> manifolds_;
 	float dt;
@@ -176,6 +178,7 @@ int main(int argc, char** argv) {
 	oak::log::cerr.addStream(&stream);
 
 	//init engine managers
+	oak::JobManager jobManager;
 	oak::EventManager evtManager;
 	oak::InputManager inputManager;
 	oak::AudioManager audioManager;
@@ -183,6 +186,8 @@ int main(int argc, char** argv) {
 	oak::SystemManager sysManager;
 	oak::ComponentTypeManager chs;
 	oak::ResourceManager resManager;
+	oak::ResourceLoader resLoader;
+	oak::ResourceReloader resReloader;
 
 	inputManager.bind("move_up", oak::key::w, true);
 	inputManager.bind("move_down", oak::key::s, true);
@@ -197,21 +202,23 @@ int main(int argc, char** argv) {
 	
 
 	//add all events
-	evtManager.addQueue<oak::EntityCreateEvent>();
-	evtManager.addQueue<oak::EntityDestroyEvent>();
-	evtManager.addQueue<oak::EntityActivateEvent>();
-	evtManager.addQueue<oak::EntityDeactivateEvent>();
-	evtManager.addQueue<oak::WindowCreateEvent>();
-	evtManager.addQueue<oak::WindowCloseEvent>();
-	evtManager.addQueue<oak::WindowResizeEvent>();
-	evtManager.addQueue<oak::FrameSizeEvent>();
-	evtManager.addQueue<oak::KeyEvent>();
-	evtManager.addQueue<oak::ButtonEvent>();
-	evtManager.addQueue<oak::CursorEvent>();
-	evtManager.addQueue<oak::CursorModeEvent>();
-	evtManager.addQueue<oak::TextEvent>();
-	evtManager.addQueue<oak::TickEvent>();
-	evtManager.addQueue<oak::SimulateEvent>();
+	//every queue is emitted on the main thread before the systems run so none of them are double buffered,
+	//the systems read this frames events and no system produces an event another system consumes
+	oak::addEventQueue<oak::EntityCreateEvent>();
+	oak::addEventQueue<oak::EntityDestroyEvent>();
+	oak::addEventQueue<oak::EntityActivateEvent>();
+	oak::addEventQueue<oak::EntityDeactivateEvent>();
+	oak::addEventQueue<oak::WindowCreateEvent>();
+	oak::addEventQueue<oak::WindowCloseEvent>();
+	oak::addEventQueue<oak::WindowResizeEvent>();
+	oak::addEventQueue<oak::FrameSizeEvent>();
+	oak::addEventQueue<oak::KeyEvent>();
+	oak::addEventQueue<oak::ButtonEvent>();
+	oak::addEventQueue<oak::CursorEvent>();
+	oak::addEventQueue<oak::CursorModeEvent>();
+	oak::addEventQueue<oak::TextEvent>();
+	oak::addEventQueue<oak::TickEvent>();
+	oak::addEventQueue<oak::SimulateEvent>();
 
 	//create component type handles
 	chs.addHandle<oak::EventComponent>("event");
@@ -239,7 +246,6 @@ int main(int argc, char** argv) {
 	auto& shaderHandle = resManager.get<oak::graphics::Shader>();
 	auto& materialHandle = resManager.get<oak::graphics::Material>();
 	auto& meshHandle = resManager.get<oak::Mesh2d>();
-	auto& audioHandle = resManager.get<oak::AudioObject>();
 
 	//create the scene
 	oak::Scene scene;
@@ -262,14 +268,19 @@ int main(int argc, char** argv) {
 	collisionSystem.scene = &scene;
 	Console console{ &scene };
 
-	//add them to the system manager
-	sysManager.addSystem(&renderSystem, "render_system");
-	sysManager.addSystem(&collisionSystem, "collision_system");
-	sysManager.addSystem(&console, "console");
+	//add them to the system manager, systems that access the same data run in this order
+	sysManager.addSystem(&console, std::hash<oak::string>{}("console"));
+	sysManager.addSystem(&collisionSystem, std::hash<oak::string>{}("collision_system"));
+	sysManager.addSystem(&renderSystem, std::hash<oak::string>{}("render_system"));
 
-	//load audio file
-	auto& snd_chip = audioHandle.add("chip", audioManager.createSound("/res/chip.ogg"));
-	audioHandle.add("test", audioManager.createSound("/res/test.ogg"));
+	//decode the audio files on the loader threads, playing a sound before it is published does nothing
+	oak::setDefaultResource<oak::AudioObject>();
+	auto snd_chip = resLoader.load<oak::AudioObject>("chip", 0, []() { return oak::AudioManager::decodeSound("/res/chip.ogg"); }, [](oak::Sound& sound) {
+		return oak::AudioManager::inst().createSound(sound);
+	});
+	resLoader.load<oak::AudioObject>("test", 0, []() { return oak::AudioManager::decodeSound("/res/test.ogg"); }, [](oak::Sound& sound) {
+		return oak::AudioManager::inst().createSound(sound);
+	});
 
 	//setup uniforms
 	oak::graphics::Camera camera;
@@ -340,24 +351,26 @@ int main(int argc, char** argv) {
 	std::chrono::high_resolution_clock::time_point lastFrame = std::chrono::high_resolution_clock::now();
 	std::chrono::duration<float> dt;
 
+	//add the entities created during setup to the scene queries
+	scene.update();
+
 	//main game loop
 	isRunning = true;
 	while (isRunning) {
 		inputManager.update();
 		audioManager.update();
-		//create / destroy / activate / deactivate entities
-		scene.update();
-
-		console.run();
+		//reload changed resources and publish the resources that finished loading since the last frame
+		resReloader.update();
+		resLoader.update();
 
+		console.update();
 		collisionSystem.dt = dt.count();
-		collisionSystem.run();
-	
-		renderSystem.run();
+		//run the console, collision and render systems, the console and collision systems touch different data and run together
+		sysManager.run();
 
 		for (auto& evt : evtManager.getQueue<oak::KeyEvent>()) {
 			if (evt.key == oak::key::p && evt.action == oak::action::released) {
-				audioManager.playSound(snd_chip, 0, 1.0f);
+				audioManager.playSound(*snd_chip, 0, 1.0f);
 			}
 		}
 
@@ -371,11 +384,18 @@ int main(int argc, char** argv) {
 		dt = std::chrono::duration_cast<std::chrono::duration<float>>(currentFrame - lastFrame);
 		lastFrame = currentFrame;
 
+		//destroy entities and update the scene queries with this frames activations before the events are cleared
+		//the queries are not changed while the systems run, the systems see this frames activations next frame
+		scene.update();
+
 		//do engine things
 		evtManager.clear();
 		oak::oalloc_frame.clear();
+		oak::memory::sample(dt.count());
 	}
 
+	oak::memory::dump("memory_stats.txt");
+
 	//clean up
 	scene.reset();
 
@@ -13,6 +13,8 @@
 #include <event_manager.h>
 #include <input_manager.h>
 #include <resource_manager.h>
+#include <resource_reloader.h>
+#include <oakengine.h>
 #include <log.h>
 
 #include "components.h"
@@ -20,6 +22,12 @@
 RenderSystem::RenderSystem(oak::Scene *scene, oak::graphics::Api *api) : scene_{ scene }, api_{ api } {}
 
 void RenderSystem::init() {
+	//the graphics context belongs to the main thread
+	mainThread_ = true;
+	readComponent<TransformComponent>();
+	readComponent<MeshComponent>();
+	readComponent<TextComponent>();
+
 	api_->init();
 
 	int frameWidth, frameHeight;
@@ -34,13 +42,17 @@ void RenderSystem::init() {
 		}
 	});
 
-	//load shader
+	//load shader, it is compiled once its files have been read on a loader thread and again whenever they change
+	//the loads replace the empty shader in place so the material keeps pointing at the current one
 	oak::graphics::ShaderInfo shaderInfo;
 	shaderInfo.vertex = "/res/shaders/poly_shader/vert.glsl";
 	shaderInfo.fragment = "/res/shaders/poly_shader/frag.glsl";
-	shader_ = oak::graphics::shader::create(shaderInfo);
-
-	material_.shader = &shader_;
+	material_.shader = &oak::addResource<oak::graphics::Shader>("poly");
+	oak::ResourceReloader::inst().load<oak::graphics::Shader>("poly", { shaderInfo.vertex, shaderInfo.fragment }, [shaderInfo]() {
+		return oak::graphics::shader::decode(shaderInfo);
+	}, [shaderInfo](oak::graphics::ShaderSource& source) {
+		return oak::graphics::shader::create(source, shaderInfo);
+	});
 
 	state_.clearColor = glm::vec4{ 0.1f, 0.1f, 0.1f, 1.0f };
 	state_.viewport = { 0, 0, frameWidth, frameHeight };
@@ -48,15 +60,11 @@ void RenderSystem::init() {
 
 	batcher_.init();
 
-	meshCache_.requireComponent<TransformComponent>();
-	meshCache_.requireComponent<MeshComponent>();
-
-	textCache_.requireComponent<TransformComponent>();
-	textCache_.requireComponent<TextComponent>();
+	meshCache_ = &scene_->getQuery<TransformComponent, MeshComponent>();
+	textCache_ = &scene_->getQuery<TransformComponent, TextComponent>();
 }
 
 void RenderSystem::terminate() {
-	oak::graphics::shader::destroy(shader_);
 	storageMesh_.destroy();
 	batcher_.terminate();
 	api_->terminate();
@@ -64,19 +72,18 @@ void RenderSystem::terminate() {
 
 void RenderSystem::run() {
 
-	meshCache_.update(*scene_);
-	textCache_.update(*scene_);
-
 	auto& ts = oak::getComponentStorage<const TransformComponent>(*scene_);
 	auto& ms = oak::getComponentStorage<const MeshComponent>(*scene_);
 	auto& txs = oak::getComponentStorage<const TextComponent>(*scene_);
 
 	//batch sprites
-	for (const auto& entity : textCache_.entities()) {
+	for (const auto& entity : textCache_->entities()) {
 		auto [tc, txc] = oak::getComponents<const TransformComponent, const TextComponent>(entity, ts, txs);
 		
 		glm::vec2 pos{ 0.0f };
 		for (const auto& c : txc.text) {
+			//a font that is still loading has no glyphs
+			if (static_cast<size_t>(c) >= txc.font->glyphs.size()) { continue; }
 			auto& glyph = txc.font->glyphs[c];			
 			batcher_.addSprite(txc.layer, txc.material, &glyph.sprite, glm::translate(tc.transform, pos));
 			pos.x += glyph.advance;
@@ -90,20 +97,28 @@ void RenderSystem::run() {
 		glm::vec2 pos;
 		unsigned char color[4];
 	};
-	oak::vector<Vertex> data;
-	size_t offset = 0, count = 0;
-
-	for (const auto& entity : meshCache_.entities()) {
-		auto [tc, mc] = oak::getComponents<const TransformComponent, const MeshComponent>(entity, ts, ms);
-
-		for (const auto& v : mc.mesh->vertices) {
-			data.push_back({ glm::vec2{ tc.transform * glm::vec3{ v.position, 1.0f } }, { 0, 155, 155, 255 } });
-			count++;
-		}
+	//reserve a range of vertices for each mesh, the batch for a mesh has the same index as its entity
+	const auto& meshes = meshCache_->entities();
+	size_t offset = 0;
+	for (const auto& entity : meshes) {
+		size_t count = oak::getComponent<const MeshComponent>(entity, ms).mesh->vertices.size();
 		batches_.push_back({ &storageMesh_, &material_, offset, count, 0, oak::graphics::Batch::DRAW_LINE_LOOP, -1 });
 		offset += count;
-		count = 0;
 	}
+
+	//transform the mesh vertices on the job threads
+	oak::vector<Vertex> data(offset);
+	oak::parallelForChunks(*meshCache_, [&](const oak::EntityId *begin, const oak::EntityId *end) {
+		size_t i = begin - meshes.data();
+		for (auto it = begin; it != end; it++, i++) {
+			auto [tc, mc] = oak::getComponents<const TransformComponent, const MeshComponent>(*it, ts, ms);
+
+			Vertex *out = data.data() + batches_[i].offset;
+			for (const auto& v : mc.mesh->vertices) {
+				*out++ = { glm::vec2{ tc.transform * glm::vec3{ v.position, 1.0f } }, { 0, 155, 155, 255 } };
+			}
+		}
+	});
 	
 	storageMesh_.data(0, data.size() * sizeof(Vertex), data.data());
 
@@ -26,8 +26,8 @@ public:
 	
 private:
 	oak::Scene *scene_;
-	oak::EntityCache meshCache_;
-	oak::EntityCache textCache_;
+	const oak::EntityCache *meshCache_;
+	const oak::EntityCache *textCache_;
 
 	oak::graphics::Api *api_;
 	oak::vector<oak::graphics::Renderer*> layers_;
@@ -36,7 +36,6 @@ private:
 	oak::graphics::SpriteBatcher batcher_;
 	
 	oak::graphics::BufferStorage storageMesh_;
-	oak::graphics::Shader shader_;
 	oak::graphics::Material material_;
 
 	oak::graphics::Api::State state_;
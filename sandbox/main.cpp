@@ -1,6 +1,7 @@
 #include <iostream>
 #include <chrono>
 #include <cmath>
+#include <functional>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/matrix_transform_2d.hpp>
@@ -17,7 +18,10 @@
 #include <log.h>
 #include <file_manager.h>
 #include <system_manager.h>
+#include <job_manager.h>
 #include <resource_manager.h>
+#include <resource_loader.h>
+#include <resource_reloader.h>
 #include <event_manager.h>
 #include <input_manager.h>
 #include <component_storage.h>
@@ -28,6 +32,7 @@
 #include <input.h>
 #include <prefab.h>
 #include <scene_utils.h>
+#include <oakengine.h>
 
 #include "components.h"
 #include "render_system.h"
@@ -39,6 +44,10 @@ public:
 	CameraSystem(oak::Scene *scene) : scene_{ scene } {}
 
 	void init() override {
+		writeComponent<CameraComponent>();
+		readComponent<oak::PrefabComponent>();
+		consumeEvent<oak::CursorEvent>();
+
 		cache_.requireComponent<oak::PrefabComponent>();
 		cache_.requireComponent<CameraComponent>();
 		cache_.requirePrefab(std::hash<oak::string>{}("player"));
@@ -111,6 +120,27 @@ private:
 
 };
 
+//uploads the view of the camera before the scene is rendered, the buffers belong to the graphics context
+class ViewSystem : public oak::System {
+public:
+	ViewSystem(oak::Scene *scene, oak::EntityId camera, std::function<void(const CameraComponent&)> upload) : 
+		scene_{ scene }, camera_{ camera }, upload_{ std::move(upload) } {}
+
+	void init() override {
+		mainThread_ = true;
+		readComponent<CameraComponent>();
+	}
+
+	void run() override {
+		upload_(oak::getComponent<const CameraComponent>(camera_, *scene_));
+	}
+
+private:
+	oak::Scene *scene_;
+	oak::EntityId camera_;
+	std::function<void(const CameraComponent&)> upload_;
+};
+
 bool isRunning = false;
 
 int main(int argc, char** argv) {
@@ -127,12 +157,15 @@ int main(int argc, char** argv) {
 	oak::log::cerr.addStream(&ls);
 
 	//init engine managers
+	oak::JobManager jobManager;
 	oak::EventManager evtManager;
 	oak::InputManager inputManager;
 	oak::FileManager fileManager;
 	oak::SystemManager sysManager;
 	oak::ComponentTypeManager chs;
 	oak::ResourceManager resManager;
+	oak::ResourceLoader resLoader;
+	oak::ResourceReloader resReloader;
 
 	inputManager.bind("move_forward", oak::key::w, true);
 	inputManager.bind("move_backward", oak::key::s, true);
@@ -145,27 +178,26 @@ int main(int argc, char** argv) {
 	fileManager.mount("{$installDir}/core/graphics/shaders", "/res/shaders");
 
 	//add all events
-	evtManager.addQueue<oak::EntityCreateEvent>();
-	evtManager.addQueue<oak::EntityDestroyEvent>();
-	evtManager.addQueue<oak::EntityActivateEvent>();
-	evtManager.addQueue<oak::EntityDeactivateEvent>();
-	evtManager.addQueue<oak::WindowCreateEvent>();
-	evtManager.addQueue<oak::WindowCloseEvent>();
-	evtManager.addQueue<oak::WindowResizeEvent>();
-	evtManager.addQueue<oak::FrameSizeEvent>();
-	evtManager.addQueue<oak::KeyEvent>();
-	evtManager.addQueue<oak::ButtonEvent>();
-	evtManager.addQueue<oak::CursorEvent>();
-	evtManager.addQueue<oak::CursorModeEvent>();
-	evtManager.addQueue<oak::TextEvent>();
-	evtManager.addQueue<oak::TickEvent>();
-	evtManager.addQueue<oak::SimulateEvent>();
+	//every queue is emitted on the main thread before the systems run so none of them are double buffered,
+	//the systems read this frames events and no system produces an event another system consumes
+	oak::addEventQueue<oak::EntityCreateEvent>();
+	oak::addEventQueue<oak::EntityDestroyEvent>();
+	oak::addEventQueue<oak::EntityActivateEvent>();
+	oak::addEventQueue<oak::EntityDeactivateEvent>();
+	oak::addEventQueue<oak::WindowCreateEvent>();
+	oak::addEventQueue<oak::WindowCloseEvent>();
+	oak::addEventQueue<oak::WindowResizeEvent>();
+	oak::addEventQueue<oak::FrameSizeEvent>();
+	oak::addEventQueue<oak::KeyEvent>();
+	oak::addEventQueue<oak::ButtonEvent>();
+	oak::addEventQueue<oak::CursorEvent>();
+	oak::addEventQueue<oak::CursorModeEvent>();
+	oak::addEventQueue<oak::TextEvent>();
+	oak::addEventQueue<oak::TickEvent>();
+	oak::addEventQueue<oak::SimulateEvent>();
 
 	//get references to resource storage containers
 	auto& bufferHandle = resManager.get<oak::graphics::Buffer>();
-	auto& textureHandle = resManager.get<oak::graphics::Texture>();
-	auto& atlasHandle = resManager.get<oak::graphics::TextureAtlas>();
-	auto& shaderHandle = resManager.get<oak::graphics::Shader>();
 	auto& materialHandle = resManager.get<oak::graphics::Material>();
 
 	//create the scene
@@ -182,9 +214,9 @@ int main(int argc, char** argv) {
 
 	CameraSystem cameraSystem{ &scene };
 
-	//add them to the system manager
-	sysManager.addSystem(&renderSystem, "render_system");
-	sysManager.addSystem(&cameraSystem, "camera_system");
+	//add them to the system manager, systems that access the same data run in this order
+	sysManager.addSystem(&cameraSystem, std::hash<oak::string>{}("camera_system"));
+	sysManager.addSystem(&renderSystem, std::hash<oak::string>{}("render_system"));
 
 	//create component type handles
 	chs.addHandle<oak::EventComponent>("event");
@@ -280,56 +312,100 @@ int main(int argc, char** argv) {
 	bufferInfo.base = 4;
 	auto& light_ubo = bufferHandle.add("light", oak::graphics::buffer::create(bufferInfo));
 	
+	//the models are only decoded on the loader threads
+	auto loadMesh = [&resLoader](const char *name, const char *path) {
+		resLoader.load<oak::graphics::Mesh>(name, 0, [path]() {
+			auto meshes = oak::graphics::loadModel(path);
+			return meshes.empty() ? oak::graphics::Mesh{} : std::move(meshes[0]);
+		});
+	};
+	loadMesh("box", "/res/models/box.obj");
+	loadMesh("part", "/res/models/bit.obj");
+	loadMesh("car", "/res/models/car.obj");
+
+	//the shaders, textures, atlases and the font are read on the loader threads, created on the main thread and loaded again when their files change
+	//a reload replaces the resource in its slot so the materials keep pointing at the current shaders and textures
+	auto loadShader = [&resReloader](const char *name, const char *vertex, const char *fragment) {
+		oak::graphics::ShaderInfo info;
+		info.vertex = vertex;
+		info.fragment = fragment;
+		resReloader.load<oak::graphics::Shader>(name, { vertex, fragment }, [info]() {
+			return oak::graphics::shader::decode(info);
+		}, [info](oak::graphics::ShaderSource& source) {
+			return oak::graphics::shader::create(source, info);
+		});
+	};
+	auto loadTexture = [&resReloader](const char *name, const char *path, const oak::graphics::TextureInfo& info) {
+		resReloader.load<oak::graphics::Texture>(name, { path }, [path, info]() {
+			return oak::graphics::texture::decode(path, info);
+		}, [info](oak::graphics::Image& image) {
+			return oak::graphics::texture::create(image, info);
+		});
+	};
+	//an atlas is rebuilt when any of its images changes
+	auto loadAtlas = [&resReloader](const char *name, const oak::vector<const char*>& paths, const oak::graphics::TextureInfo& info) {
+		resReloader.load<oak::graphics::TextureAtlas>(name, { std::begin(paths), std::end(paths) }, [paths, info]() {
+			return oak::graphics::texture::decodeAtlas(paths, info);
+		}, [paths, info](oak::vector<oak::graphics::Image>& images) {
+			return oak::graphics::texture::createAtlas(images, paths, info);
+		});
+	};
+
 	//shader setup
-	oak::graphics::ShaderInfo shaderInfo;
-	shaderInfo.vertex = "/res/shaders/deferred/geometry/vert.glsl";
-	shaderInfo.fragment = "/res/shaders/deferred/geometry/frag.glsl";
-	auto& sh_geometry = shaderHandle.add("geometry", oak::graphics::shader::create(shaderInfo));
-	shaderInfo.vertex = "/res/shaders/forward/pass2d/vert.glsl";
-	shaderInfo.fragment = "/res/shaders/forward/pass2d/frag.glsl";
-	auto& sh_pass2d = shaderHandle.add("pass2d", oak::graphics::shader::create(shaderInfo));
-	shaderInfo.vertex = "/res/shaders/forward/font/vert.glsl";
-	shaderInfo.fragment = "/res/shaders/forward/font/frag.glsl";
-	auto& sh_font = shaderHandle.add("font", oak::graphics::shader::create(shaderInfo));
-	shaderInfo.vertex = "/res/shaders/deferred/particle/vert.glsl";
-	shaderInfo.fragment = "/res/shaders/deferred/particle/frag.glsl";
-	auto& sh_particle = shaderHandle.add("particle", oak::graphics::shader::create(shaderInfo));
+	loadShader("geometry", "/res/shaders/deferred/geometry/vert.glsl", "/res/shaders/deferred/geometry/frag.glsl");
+	loadShader("pass2d", "/res/shaders/forward/pass2d/vert.glsl", "/res/shaders/forward/pass2d/frag.glsl");
+	loadShader("font", "/res/shaders/forward/font/vert.glsl", "/res/shaders/forward/font/frag.glsl");
+	loadShader("particle", "/res/shaders/deferred/particle/vert.glsl", "/res/shaders/deferred/particle/frag.glsl");
 	//textures
 	oak::graphics::TextureInfo textureInfo;
 	textureInfo.minFilter = oak::graphics::TextureFilter::NEAREST;
-	auto& tex_character = textureHandle.add("character", oak::graphics::texture::create("/res/textures/character.png", textureInfo));
+	loadTexture("character", "/res/textures/character.png", textureInfo);
 	textureInfo.minFilter = oak::graphics::TextureFilter::LINEAR;
 	textureInfo.magFilter = oak::graphics::TextureFilter::LINEAR;
-	auto& tex_font = textureHandle.add("font", oak::graphics::texture::create("/res/fonts/dejavu_sans/atlas.png", textureInfo));
+	loadTexture("font", "/res/fonts/dejavu_sans/atlas.png", textureInfo);
 	textureInfo.minFilter = oak::graphics::TextureFilter::LINEAR_MIP_NEAREST;
 	textureInfo.magFilter = oak::graphics::TextureFilter::NEAREST;
-	auto& tex_car = textureHandle.add("car", oak::graphics::texture::create("/res/textures/car.png", textureInfo));
+	loadTexture("car", "/res/textures/car.png", textureInfo);
 	textureInfo.width = 4096;
 	textureInfo.height = 4096;
-	auto& colorAtlas = atlasHandle.add("color", 
-		oak::graphics::texture::createAtlas({ 
-			"/res/textures/pbr_rust/color.png",
-			"/res/textures/pbr_grass/color.png",
-			"/res/textures/pbr_rock/color.png",
-		}, textureInfo));
-	auto& normalAtlas = atlasHandle.add("normal",
-		oak::graphics::texture::createAtlas({
-			"/res/textures/pbr_rust/normal.png",
-			"/res/textures/pbr_grass/normal.png"
-		},	textureInfo));
+	loadAtlas("color", {
+		"/res/textures/pbr_rust/color.png",
+		"/res/textures/pbr_grass/color.png",
+		"/res/textures/pbr_rock/color.png",
+	}, textureInfo);
+	loadAtlas("normal", {
+		"/res/textures/pbr_rust/normal.png",
+		"/res/textures/pbr_grass/normal.png"
+	}, textureInfo);
 	textureInfo.format = oak::graphics::TextureFormat::BYTE_R;
-	auto& metalAtlas = atlasHandle.add("metal",
-		oak::graphics::texture::createAtlas({
-			"/res/textures/pbr_rust/metalness.png",
-			"/res/textures/pbr_grass/metalness.png",
-			"/res/textures/pbr_rock/metalness.png"
-		}, textureInfo));
-	auto& roughAtlas = atlasHandle.add("rough",
-		oak::graphics::texture::createAtlas({
-			"/res/textures/pbr_rust/roughness.png",
-			"/res/textures/pbr_grass/roughness.png",
-			"/res/textures/pbr_rock/roughness.png"
-		}, textureInfo));
+	loadAtlas("metal", {
+		"/res/textures/pbr_rust/metalness.png",
+		"/res/textures/pbr_grass/metalness.png",
+		"/res/textures/pbr_rock/metalness.png"
+	}, textureInfo);
+	loadAtlas("rough", {
+		"/res/textures/pbr_rust/roughness.png",
+		"/res/textures/pbr_grass/roughness.png",
+		"/res/textures/pbr_rock/roughness.png"
+	}, textureInfo);
+	//the glyph regions are laid out on the font texture so the glyphs are read again when it changes
+	resReloader.load<oak::graphics::Font>("dejavu", { "/res/fonts/dejavu_sans/glyphs.fnt" }, []() {
+		return oak::graphics::loadFont("/res/fonts/dejavu_sans/glyphs.fnt");
+	});
+	resReloader.addDependency<oak::graphics::Font, oak::graphics::Texture>("dejavu", "font");
+
+	//the materials, models and the font are referenced by pointer so everything has to be published first
+	resLoader.finish();
+	auto& sh_geometry = oak::requireResource<oak::graphics::Shader>("geometry");
+	auto& sh_pass2d = oak::requireResource<oak::graphics::Shader>("pass2d");
+	auto& sh_font = oak::requireResource<oak::graphics::Shader>("font");
+	auto& sh_particle = oak::requireResource<oak::graphics::Shader>("particle");
+	auto& tex_character = oak::requireResource<oak::graphics::Texture>("character");
+	auto& tex_font = oak::requireResource<oak::graphics::Texture>("font");
+	auto& tex_car = oak::requireResource<oak::graphics::Texture>("car");
+	auto& colorAtlas = oak::requireResource<oak::graphics::TextureAtlas>("color");
+	auto& metalAtlas = oak::requireResource<oak::graphics::TextureAtlas>("metal");
+	auto& roughAtlas = oak::requireResource<oak::graphics::TextureAtlas>("rough");
 
 	//materials
 	auto& mat_box = materialHandle.add("box", &sh_geometry, &colorAtlas.texture, &roughAtlas.texture, &metalAtlas.texture);
@@ -339,9 +415,9 @@ int main(int argc, char** argv) {
 	auto& mat_font = materialHandle.add("font", &sh_font, &tex_font);
 
 	//meshes
-	auto model_box = oak::graphics::loadModel("/res/models/box.obj");
-	auto model_part = oak::graphics::loadModel("/res/models/bit.obj");
-	auto model_car = oak::graphics::loadModel("/res/models/car.obj");
+	auto& model_box = oak::requireResource<oak::graphics::Mesh>("box");
+	auto& model_part = oak::requireResource<oak::graphics::Mesh>("part");
+	auto& model_car = oak::requireResource<oak::graphics::Mesh>("car");
 	oak::graphics::Mesh mesh_floor;
 
 	mesh_floor.vertices = {
@@ -357,7 +433,7 @@ int main(int argc, char** argv) {
 
 	oak::graphics::Sprite spr_overlay{ 0.0f, 0.0f, 64.0f, 64.0f, { glm::vec2{ 0.0f }, glm::vec2{ 1.0f } } };
 
-	oak::graphics::Font fnt_dejavu = oak::graphics::loadFont("/res/fonts/dejavu_sans/glyphs.fnt");
+	auto& fnt_dejavu = oak::requireResource<oak::graphics::Font>("dejavu");
 
 	//create entities
 	oak::EntityId player = scene.createEntity();
@@ -368,12 +444,12 @@ int main(int argc, char** argv) {
 
 	oak::EntityId car = scene.createEntity();
 	oak::addComponent<TransformComponent>(car, scene, glm::translate(glm::mat4{ 1.0f }, glm::vec3{ 32.0f, 1.0f, 32.0f }));
-	oak::addComponent<MeshComponent>(car, scene, &model_car[0], &mat_car);
+	oak::addComponent<MeshComponent>(car, scene, &model_car, &mat_car);
 	scene.activateEntity(car);
 
 	oak::EntityId particle = scene.createEntity();
 	oak::addComponent<oak::PrefabComponent>(particle, scene, std::hash<oak::string>{}("particle"));
-	oak::addComponent<MeshComponent>(particle, scene, &model_part[0], &mat_part, colorAtlas.regions[0].second);
+	oak::addComponent<MeshComponent>(particle, scene, &model_part, &mat_part, colorAtlas.regions[0].second);
 	scene.activateEntity(particle);
 
 	oak::EntityId overlay = scene.createEntity();
@@ -386,9 +462,26 @@ int main(int argc, char** argv) {
 	oak::addComponent<TextComponent>(fps, scene, "fps: ", &fnt_dejavu, &mat_font, 1u);
 	scene.activateEntity(fps);
 
+	//the view is uploaded after the camera moves and before the render system draws with it
+	ViewSystem viewSystem{ &scene, player, [&](const CameraComponent& cc) {
+		camera3d.view3d(cc.position, glm::quat{ cc.rotation });
+		//update lights
+		for (int i = 0; i < 8; i++) {
+			lights[i].pos = glm::vec3{ camera3d.view * glm::vec4{ lpos[i], 1.0f} };
+		}
+
+		//upload buffers
+		oak::graphics::buffer::bind(matrix_ubo);
+		oak::graphics::buffer::data(matrix_ubo, sizeof(camera3d), &camera3d);
+		oak::graphics::buffer::bind(light_ubo);
+		oak::graphics::buffer::data(light_ubo, sizeof(lights), &lights);
+	} };
+	sysManager.addSystem(&viewSystem, std::hash<oak::string>{}("view_system"));
+	sysManager.addDependency(std::hash<oak::string>{}("render_system"), std::hash<oak::string>{}("view_system"));
+
 	oak::Prefab fab_box{ "box", scene };
 	fab_box.addComponent<TransformComponent>();
-	fab_box.addComponent<MeshComponent>(&model_box[0], &mat_box, colorAtlas.regions[2].second, 0u);
+	fab_box.addComponent<MeshComponent>(&model_box, &mat_box, colorAtlas.regions[2].second, 0u);
 
 	oak::EntityId floor = scene.createEntity();
 	oak::addComponent<oak::PrefabComponent>(floor, scene, std::hash<oak::string>{}("floor"));
@@ -396,6 +489,9 @@ int main(int argc, char** argv) {
 	oak::addComponent<MeshComponent>(floor, scene, &mesh_floor, &mat_box, colorAtlas.regions[1].second, 0u);
 	scene.activateEntity(floor);
 
+	//add the entities created during setup to the scene queries
+	scene.update();
+
 	//first frame time
 	std::chrono::high_resolution_clock::time_point lastFrame = std::chrono::high_resolution_clock::now();
 	std::chrono::duration<float> dt;
@@ -412,25 +508,11 @@ int main(int argc, char** argv) {
 			inputManager.setKey(oak::key::esc, 0);
 		}
 		inputManager.update();
-		//create / destroy / activate / deactivate entities
-		scene.update();
-		//move camera
-		cameraSystem.run();
-		//update view
-		auto& cc = oak::getComponent<const CameraComponent>(player, scene);
-		camera3d.view3d(cc.position, glm::quat{ cc.rotation });
-		//update lights
-		for (int i = 0; i < 8; i++) {
-			lights[i].pos = glm::vec3{ camera3d.view * glm::vec4{ lpos[i], 1.0f} };
-		}
-
-		//upload buffers
-		oak::graphics::buffer::bind(matrix_ubo);
-		oak::graphics::buffer::data(matrix_ubo, sizeof(camera3d), &camera3d);
-		oak::graphics::buffer::bind(light_ubo);
-		oak::graphics::buffer::data(light_ubo, sizeof(lights), &lights);
-	
-		renderSystem.run();
+		//reload changed resources and publish them
+		resReloader.update();
+		resLoader.update();
+		//move the camera, upload its view and render the scene
+		sysManager.run();
 
 		//check for exit
 		if (!evtManager.getQueue<oak::WindowCloseEvent>().empty()) {
@@ -444,6 +526,9 @@ int main(int argc, char** argv) {
 
 		oak::getComponent<TextComponent>(fps, scene).text = "fps: " + std::to_string(1.0f / dt.count());
 
+		//destroy entities and update the scene queries with this frames activations before the events are cleared
+		scene.update();
+
 		//do engine things
 		evtManager.clear();
 		oak::oalloc_frame.clear();
@@ -20,6 +20,17 @@
 RenderSystem::RenderSystem(oak::Scene *scene, oak::graphics::Api *api) : scene_{ scene }, api_{ api } {}
 
 void RenderSystem::init() {
+	//the graphics context belongs to the main thread
+	mainThread_ = true;
+	readComponent<TransformComponent>();
+	readComponent<Transform2dComponent>();
+	readComponent<MeshComponent>();
+	readComponent<SpriteComponent>();
+	readComponent<TextComponent>();
+	readComponent<oak::PrefabComponent>();
+	consumeEvent<oak::EntityActivateEvent>();
+	consumeEvent<oak::EntityDeactivateEvent>();
+
 	api_->init();
 
 	int frameWidth, frameHeight;
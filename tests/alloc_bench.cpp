@@ -0,0 +1,296 @@
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <oak_alloc.h>
+#include <container.h>
+
+//allocator benchmarks, results are written as csv or json so runs can be compared
+//usage: alloc_bench [csv|json] [output path]
+
+//the work of a run is split between its threads so runs with different thread counts do the same number of operations
+constexpr size_t OP_COUNT = 65536; //alloc/free pairs in each run
+constexpr size_t BATCH_SIZE = 1024;
+constexpr size_t LIVE_COUNT = 2048; //live blocks in the churn pattern
+
+struct Result {
+	const char *allocator;
+	const char *pattern;
+	const char *distribution;
+	size_t threads;
+	size_t ops;
+	double nsPerOp;
+};
+
+std::vector<Result> results;
+
+//the c library allocator behind the same interface as the oak allocators
+class MallocAllocator : public oak::Allocator {
+public:
+	MallocAllocator() : Allocator{ nullptr, 16 } {}
+
+	void* allocate(size_t size) override { return malloc(size); }
+	void deallocate(void *ptr, size_t size) override { free(ptr); }
+};
+
+struct Random {
+	uint32_t seed;
+
+	uint32_t operator()() {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+};
+
+enum class Distribution {
+	FIXED, //every allocation is 48 bytes
+	SMALL, //8 to 256 bytes
+	MIXED, //shaped like the engines container traffic
+	LARGE //4kb to 64kb
+};
+
+const char* distributionNames[] = { "fixed", "small", "mixed", "large" };
+
+size_t randomSize(Distribution distribution, Random& random) {
+	switch (distribution) {
+		case Distribution::FIXED: return 48;
+		case Distribution::SMALL: return 8 + random() % 249;
+		case Distribution::MIXED: {
+			uint32_t r = random() % 100;
+			if (r < 70) { return 8 + random() % 56; }
+			if (r < 90) { return 64 + random() % 448; }
+			if (r < 99) { return 512 + random() % 3584; }
+			return 4096 + random() % 61440;
+		}
+		case Distribution::LARGE: return 4096 + random() % 61440;
+	}
+	return 0;
+}
+
+enum class Pattern {
+	LIFO, //allocate a batch and free it in reverse
+	FIFO, //allocate a batch and free it in order
+	CHURN //replace random blocks in a window of live allocations
+};
+
+const char* patternNames[] = { "lifo", "fifo", "churn" };
+
+struct Block {
+	void *ptr;
+	size_t size;
+};
+
+//arenas cannot free individual blocks so they are reset after every batch instead
+struct Target {
+	const char *name;
+	oak::Allocator *allocator;
+	void (*reset)(oak::Allocator*);
+	bool threadSafe;
+};
+
+void run(const Target& target, Pattern pattern, Distribution distribution, size_t thread, size_t threadCount) {
+	oak::Allocator& allocator = *target.allocator;
+	Random random{ 2463534242u + static_cast<uint32_t>(thread) * 7919u };
+	const size_t ops = OP_COUNT / threadCount;
+	const size_t live = LIVE_COUNT / threadCount;
+	std::vector<Block> blocks(pattern == Pattern::CHURN ? live : BATCH_SIZE, { nullptr, 0 });
+
+	if (pattern == Pattern::CHURN) {
+		for (size_t i = 0; i < ops; i++) {
+			auto& block = blocks[random() % live];
+			if (block.ptr != nullptr) {
+				allocator.deallocate(block.ptr, block.size);
+			}
+			block.size = randomSize(distribution, random);
+			block.ptr = allocator.allocate(block.size);
+			*static_cast<uint8_t*>(block.ptr) = 1;
+		}
+		for (auto& block : blocks) {
+			if (block.ptr != nullptr) {
+				allocator.deallocate(block.ptr, block.size);
+			}
+		}
+		return;
+	}
+
+	for (size_t done = 0; done < ops; done += BATCH_SIZE) {
+		for (auto& block : blocks) {
+			block.size = randomSize(distribution, random);
+			block.ptr = allocator.allocate(block.size);
+			*static_cast<uint8_t*>(block.ptr) = 1;
+		}
+		if (pattern == Pattern::LIFO) {
+			for (size_t i = BATCH_SIZE; i > 0; i--) {
+				allocator.deallocate(blocks[i - 1].ptr, blocks[i - 1].size);
+			}
+		} else {
+			for (auto& block : blocks) {
+				allocator.deallocate(block.ptr, block.size);
+			}
+		}
+		if (target.reset != nullptr) {
+			target.reset(target.allocator);
+		}
+	}
+}
+
+void bench(const Target& target, Pattern pattern, Distribution distribution, size_t threadCount) {
+	auto start = std::chrono::steady_clock::now();
+	if (threadCount == 1) {
+		run(target, pattern, distribution, 0, 1);
+	} else {
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threadCount; t++) {
+			threads.emplace_back([&target, pattern, distribution, t, threadCount]() { run(target, pattern, distribution, t, threadCount); });
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	const size_t ops = OP_COUNT;
+	results.push_back({ target.name, patternNames[static_cast<int>(pattern)], distributionNames[static_cast<int>(distribution)],
+		threadCount, ops, std::chrono::duration<double, std::nano>{ end - start }.count() / ops });
+}
+
+template<class F>
+void benchContainer(const char *allocator, const char *pattern, size_t ops, F&& func) {
+	auto start = std::chrono::steady_clock::now();
+	func();
+	auto end = std::chrono::steady_clock::now();
+	results.push_back({ allocator, pattern, "container", 1, ops, std::chrono::duration<double, std::nano>{ end - start }.count() / ops });
+}
+
+//oak containers against the standard library ones
+template<template<class> class Alloc, class String>
+void containerBench(const char *name) {
+	constexpr size_t COUNT = 100000;
+	volatile size_t sink = 0;
+
+	benchContainer(name, "vector_push", COUNT * 16, [&]() {
+		for (size_t i = 0; i < 16; i++) {
+			std::vector<int, Alloc<int>> values;
+			for (size_t j = 0; j < COUNT; j++) {
+				values.push_back(static_cast<int>(j));
+			}
+			sink += values.size();
+		}
+	});
+
+	benchContainer(name, "string_build", COUNT, [&]() {
+		std::vector<String, Alloc<String>> strings;
+		for (size_t i = 0; i < COUNT; i++) {
+			String str{ "entity[" };
+			str += std::to_string(i).c_str();
+			str += "].transform.position";
+			strings.push_back(std::move(str));
+		}
+		sink += strings.size();
+	});
+
+	benchContainer(name, "map_insert", COUNT, [&]() {
+		std::unordered_map<size_t, size_t, std::hash<size_t>, std::equal_to<size_t>, Alloc<std::pair<const size_t, size_t>>> map;
+		for (size_t i = 0; i < COUNT; i++) {
+			map[i * 2654435761u] = i;
+		}
+		sink += map.size();
+	});
+}
+
+void writeResults(FILE *file, bool json) {
+	if (json) {
+		fprintf(file, "[\n");
+		for (size_t i = 0; i < results.size(); i++) {
+			const auto& r = results[i];
+			fprintf(file, "\t{ \"allocator\": \"%s\", \"pattern\": \"%s\", \"distribution\": \"%s\", \"threads\": %lu, \"ops\": %lu, \"ns_per_op\": %.2f }%s\n",
+				r.allocator, r.pattern, r.distribution, r.threads, r.ops, r.nsPerOp, i + 1 < results.size() ? "," : "");
+		}
+		fprintf(file, "]\n");
+	} else {
+		fprintf(file, "allocator,pattern,distribution,threads,ops,ns_per_op\n");
+		for (const auto& r : results) {
+			fprintf(file, "%s,%s,%s,%lu,%lu,%.2f\n", r.allocator, r.pattern, r.distribution, r.threads, r.ops, r.nsPerOp);
+		}
+	}
+}
+
+template<class T>
+using OakAlloc = oak::detail::oalloc<T>;
+
+int main(int argc, char **argv) {
+
+	const bool json = argc > 1 && strcmp(argv[1], "json") == 0;
+	const char *path = argc > 2 ? argv[2] : nullptr;
+
+	MallocAllocator malloc_;
+	oak::ProxyAllocator proxy;
+	oak::FreelistAllocator freelist{ &proxy, 256000000, 64 };
+	oak::SizeClassAllocator sizeclass{ &freelist };
+	oak::PoolAllocator pool{ &freelist, 65536, 48 };
+	oak::LinearAllocator linear{ &freelist, 1000000, 16 };
+	oak::StackAllocator stack{ 1000000000 };
+
+	auto clearLinear = [](oak::Allocator *allocator) { static_cast<oak::LinearAllocator*>(allocator)->clear(); };
+	//returns the slab pages emptied by the batch, the next batch has to grow them again
+	auto trimSizeclass = [](oak::Allocator *allocator) { static_cast<oak::SizeClassAllocator*>(allocator)->trim(); };
+
+	const Target targets[] = {
+		{ "malloc", &malloc_, nullptr, true },
+		{ "proxy", &proxy, nullptr, true },
+		{ "freelist", &freelist, nullptr, true },
+		{ "sizeclass", &sizeclass, nullptr, true },
+		{ "stack", &stack, nullptr, false }
+	};
+
+	const size_t threadCounts[] = { 1, 2, 4, 8 };
+
+	for (const auto& target : targets) {
+		for (auto distribution : { Distribution::SMALL, Distribution::MIXED, Distribution::LARGE }) {
+			for (auto pattern : { Pattern::LIFO, Pattern::FIFO, Pattern::CHURN }) {
+				//the stack allocator only frees in reverse order
+				if (target.allocator == &stack && pattern != Pattern::LIFO) { continue; }
+				for (auto threads : threadCounts) {
+					if (threads > 1 && !target.threadSafe) { break; }
+					bench(target, pattern, distribution, threads);
+				}
+			}
+		}
+	}
+
+	//fixed size allocators
+	for (auto pattern : { Pattern::LIFO, Pattern::FIFO, Pattern::CHURN }) {
+		bench({ "malloc", &malloc_, nullptr, true }, pattern, Distribution::FIXED, 1);
+		bench({ "sizeclass", &sizeclass, nullptr, true }, pattern, Distribution::FIXED, 1);
+		bench({ "pool", &pool, nullptr, false }, pattern, Distribution::FIXED, 1);
+	}
+	//trimming the size class allocator after every batch
+	for (auto distribution : { Distribution::SMALL, Distribution::MIXED }) {
+		for (auto pattern : { Pattern::LIFO, Pattern::FIFO }) {
+			bench({ "sizeclass_trim", &sizeclass, trimSizeclass, false }, pattern, distribution, 1);
+		}
+	}
+	//blocks smaller than a linear allocator page, the allocator is cleared after each batch
+	bench({ "linear", &linear, clearLinear, false }, Pattern::FIFO, Distribution::SMALL, 1);
+
+	containerBench<std::allocator, std::string>("std");
+	containerBench<OakAlloc, oak::string>("oak");
+
+	FILE *file = path != nullptr ? fopen(path, "w") : stdout;
+	if (file == nullptr) {
+		printf("failed to open: %s\n", path);
+		return -1;
+	}
+	writeResults(file, json);
+	if (file != stdout) {
+		fclose(file);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include <thread>
+#include <cstring>
+#include <atomic>
+#include <memory_resource>
+#include <cerrno>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <oak_alloc.h>
+#include <memory_resource.h>
+#include <container.h>
+
+constexpr size_t THREAD_COUNT = 8;
+constexpr size_t OP_COUNT = 200000; //per thread
+constexpr size_t LIVE_COUNT = 1024; //per thread
+
+namespace oak::debug::vars {
+	extern std::atomic<size_t> usedMemory;
+	extern std::atomic<size_t> allocatedMemory;
+}
+
+struct Block {
+	uint8_t *ptr = nullptr;
+	size_t size = 0;
+	uint8_t value = 0;
+};
+
+std::atomic<bool> failed{ false };
+
+bool check(const Block& block) {
+	for (size_t i = 0; i < block.size; i++) {
+		if (block.ptr[i] != block.value) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//random allocations through oak_allocator and oak containers, every block is filled and checked before it is freed
+void work(size_t thread, oak::vector<Block>& handoff) {
+	uint32_t seed = 2463534242u + static_cast<uint32_t>(thread) * 7919u;
+	auto random = [&seed]() {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	};
+
+	oak::vector<Block> blocks(LIVE_COUNT);
+	oak::vector<oak::string> strings;
+	for (size_t i = 0; i < OP_COUNT; i++) {
+		auto& block = blocks[random() % LIVE_COUNT];
+		if (block.ptr != nullptr) {
+			if (!check(block)) { failed = true; return; }
+			oak::oak_allocator.deallocate(block.ptr, block.size);
+		}
+		block.size = 1 + (random() % 100 < 95 ? random() % 512 : random() % 16384);
+		block.value = static_cast<uint8_t>(random());
+		block.ptr = static_cast<uint8_t*>(oak::oak_allocator.allocate(block.size));
+		std::memset(block.ptr, block.value, block.size);
+
+		//container growth
+		strings.push_back(oak::string(1 + random() % 64, static_cast<char>('a' + thread)));
+		if (strings.size() > 256) {
+			for (const auto& str : strings) {
+				for (auto c : str) {
+					if (c != static_cast<char>('a' + thread)) { failed = true; return; }
+				}
+			}
+			strings.clear();
+			strings.shrink_to_fit();
+		}
+	}
+
+	//the remaining blocks are freed by another thread
+	handoff = std::move(blocks);
+}
+
+int main(int argc, char **argv) {
+
+	const size_t startMemory = oak::debug::vars::usedMemory.load();
+
+	{
+		oak::vector<oak::vector<Block>> handoffs(THREAD_COUNT);
+		oak::vector<std::thread> threads;
+		for (size_t t = 0; t < THREAD_COUNT; t++) {
+			threads.emplace_back([t, &handoffs]() { work(t, handoffs[t]); });
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		threads.clear();
+
+		if (failed) {
+			printf("corrupted allocation\n");
+			return -1;
+		}
+
+		//free every threads blocks from a different thread
+		for (size_t t = 0; t < THREAD_COUNT; t++) {
+			threads.emplace_back([t, &handoffs]() {
+				for (auto& block : handoffs[(t + 1) % THREAD_COUNT]) {
+					if (block.ptr == nullptr) { continue; }
+					if (!check(block)) { failed = true; }
+					oak::oak_allocator.deallocate(block.ptr, block.size);
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		if (failed) {
+			printf("corrupted allocation\n");
+			return -1;
+		}
+	}
+
+	const size_t endMemory = oak::debug::vars::usedMemory.load();
+	if (endMemory != startMemory) {
+		printf("used memory: %lu, expected: %lu\n", endMemory, startMemory);
+		return -1;
+	}
+
+	//pool pages are returned once they are empty
+	{
+		constexpr size_t OBJECT_COUNT = 100000;
+		oak::PoolAllocator pool{ &oak::oalloc_freelist, 8192, 48 };
+		oak::vector<uint8_t*> objects;
+		for (size_t i = 0; i < OBJECT_COUNT; i++) {
+			auto ptr = static_cast<uint8_t*>(pool.allocate(48));
+			std::memset(ptr, static_cast<int>(i), 48);
+			objects.push_back(ptr);
+		}
+		const size_t fullPages = pool.getPageCount();
+		const size_t fullCommitted = pool.getCommitted();
+		const size_t fullAllocated = oak::debug::vars::allocatedMemory.load();
+		//free every other object, no page becomes empty
+		for (size_t i = 0; i < OBJECT_COUNT; i += 2) {
+			pool.deallocate(objects[i], 48);
+		}
+		if (pool.getPageCount() != fullPages || pool.getFragmentation() < 0.45f) {
+			printf("pages: %lu, expected: %lu, fragmentation: %f\n", pool.getPageCount(), fullPages, pool.getFragmentation());
+			return -1;
+		}
+		for (size_t i = 1; i < OBJECT_COUNT; i += 2) {
+			for (size_t j = 0; j < 48; j++) {
+				if (objects[i][j] != static_cast<uint8_t>(i)) {
+					printf("pool object %lu corrupted\n", i);
+					return -1;
+				}
+			}
+			pool.deallocate(objects[i], 48);
+		}
+		if (pool.getObjectCount() != 0 || pool.getPageCount() > 1) {
+			printf("objects: %lu, pages: %lu after freeing everything\n", pool.getObjectCount(), pool.getPageCount());
+			return -1;
+		}
+		pool.trim();
+		if (pool.getPageCount() != 0 || pool.getCommitted() != 0) {
+			printf("pages: %lu, committed: %lu after trim\n", pool.getPageCount(), pool.getCommitted());
+			return -1;
+		}
+		//the pages went back to the os, not to a free list of the parent
+		const size_t released = fullAllocated - oak::debug::vars::allocatedMemory.load();
+		if (released != fullCommitted) {
+			printf("released: %lu, expected: %lu\n", released, fullCommitted);
+			return -1;
+		}
+		const size_t osPage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		unsigned char resident;
+		void *firstPage = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(objects[0]) & ~(osPage - 1));
+		if (mincore(firstPage, osPage, &resident) == 0 || errno != ENOMEM) {
+			printf("pool page %p is still mapped after trim\n", firstPage);
+			return -1;
+		}
+	}
+
+	//slab pages whose slots are all free are returned by trim
+	{
+		oak::SizeClassAllocator sizeclass{ &oak::oalloc_freelist };
+		oak::vector<void*> small, large;
+		for (size_t i = 0; i < 20000; i++) {
+			small.push_back(sizeclass.allocate(48));
+			large.push_back(sizeclass.allocate(1000));
+		}
+		const size_t pages = sizeclass.getPageCount();
+		//every small slot is freed, every other large one stays live
+		for (auto ptr : small) {
+			sizeclass.deallocate(ptr, 48);
+		}
+		for (size_t i = 0; i < large.size(); i += 2) {
+			sizeclass.deallocate(large[i], 1000);
+		}
+		sizeclass.trim();
+		const size_t kept = sizeclass.getPageCount();
+		if (kept == 0 || kept >= pages) {
+			printf("slab pages: %lu, before trim: %lu\n", kept, pages);
+			return -1;
+		}
+		//the remaining free slots still belong to live pages
+		for (size_t i = 0; i < large.size(); i += 2) {
+			large[i] = sizeclass.allocate(1000);
+			std::memset(large[i], 0xab, 1000);
+		}
+		for (auto ptr : large) {
+			sizeclass.deallocate(ptr, 1000);
+		}
+		sizeclass.trim();
+		if (sizeclass.getPageCount() != 0) {
+			printf("slab pages: %lu after freeing everything\n", sizeclass.getPageCount());
+			return -1;
+		}
+	}
+
+	//tagged allocations are accounted against their tag
+	{
+		const auto before = oak::memory::getStats(oak::MemoryTag::AUDIO);
+		void *ptr = oak::oalloc_tagged(oak::MemoryTag::AUDIO)->allocate(1000);
+		const auto during = oak::memory::getStats(oak::MemoryTag::AUDIO);
+		oak::oalloc_tagged(oak::MemoryTag::AUDIO)->deallocate(ptr, 1000);
+		const auto after = oak::memory::getStats(oak::MemoryTag::AUDIO);
+#ifdef OAK_MEMORY_TRACKING
+		if (during.liveBytes != before.liveBytes + 1000 || during.peakBytes < during.liveBytes ||
+			after.liveBytes != before.liveBytes || after.allocCount != before.allocCount + 1 || after.freeCount != before.freeCount + 1) {
+			printf("incorrect audio stats, live: %lu, peak: %lu, allocs: %lu\n", during.liveBytes, during.peakBytes, after.allocCount);
+			return -1;
+		}
+#else
+		(void)before; (void)during; (void)after;
+#endif
+	}
+
+	//pages committed by a virtual arena are accounted against its tag until they are trimmed
+	{
+		const auto before = oak::memory::getStats(oak::MemoryTag::EVENTS);
+		oak::VirtualArena arena{ 1 << 24, 1 << 16, 1 << 22, 16, oak::MemoryTag::EVENTS };
+		arena.allocate(100000);
+		const size_t committed = arena.getCommitted();
+		const auto during = oak::memory::getStats(oak::MemoryTag::EVENTS);
+		arena.clear();
+		arena.trim();
+		const auto after = oak::memory::getStats(oak::MemoryTag::EVENTS);
+#ifdef OAK_MEMORY_TRACKING
+		if (committed < 100000 || during.liveBytes != before.liveBytes + committed || after.liveBytes != before.liveBytes) {
+			printf("incorrect arena stats, live: %lu, after trim: %lu\n", during.liveBytes - before.liveBytes, after.liveBytes - before.liveBytes);
+			return -1;
+		}
+#else
+		(void)before; (void)during; (void)after; (void)committed;
+#endif
+	}
+
+	//pmr containers over oak allocators and oak containers over pmr resources
+	{
+		std::pmr::vector<size_t> values{ &oak::oak_resource };
+		for (size_t i = 0; i < 10000; i++) {
+			values.push_back(i);
+		}
+		//over aligned requests
+		void *ptr = oak::oak_resource.allocate(100, 256);
+		if (reinterpret_cast<uintptr_t>(ptr) % 256 != 0) {
+			printf("misaligned pmr allocation: %p\n", ptr);
+			return -1;
+		}
+		oak::oak_resource.deallocate(ptr, 100, 256);
+
+		char buffer[4096];
+		std::pmr::monotonic_buffer_resource monotonic{ buffer, sizeof(buffer), std::pmr::null_memory_resource() };
+		oak::ResourceAllocator resourceAllocator{ &monotonic };
+		oak::vector<int> ints{ oak::OakAllocator<int>{ &resourceAllocator } };
+		ints.reserve(256);
+		for (int i = 0; i < 256; i++) {
+			ints.push_back(i);
+		}
+		if (reinterpret_cast<char*>(ints.data()) < buffer || reinterpret_cast<char*>(ints.data()) >= buffer + sizeof(buffer) || ints[255] != 255) {
+			printf("oak vector did not use the monotonic buffer\n");
+			return -1;
+		}
+	}
+
+	printf("done\n");
+
+	return 0;
+}
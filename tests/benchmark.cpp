@@ -5,6 +5,8 @@
 #include <entity_id.h>
 #include <entity_cache.h>
 #include <container.h>
+#include <archetype_storage.h>
+#include <resource.h>
 #include <chrono>
 
 struct TransformComponent {
@@ -48,26 +50,12 @@ void pup(oak::Puper& puper, BoxComponent& data, const oak::ObjInfo& info) {}
 std::chrono::high_resolution_clock::time_point start;
 std::chrono::high_resolution_clock::time_point end;
 
-std::vector<std::pair<std::string, size_t>> times;
+std::vector<std::pair<oak::string, size_t>> times;
 
-void oak_bench() {
-
-	oak::EventManager evtManager;
-	
-	oak::addEventQueue<oak::EntityCreateEvent>();
-	oak::addEventQueue<oak::EntityDestroyEvent>();
-	oak::addEventQueue<oak::EntityActivateEvent>();
-	oak::addEventQueue<oak::EntityDeactivateEvent>();
+void oak_bench(const char *name, size_t count, size_t frames, oak::StorageMode mode) {
 
 	oak::Scene scene;
-	oak::ComponentTypeManager ctm;
-
-	ctm.addType<TransformComponent>();
-	ctm.addType<DrawComponent>();
-	ctm.addType<VelocityComponent>();
-	ctm.addType<BoxComponent>();
-
-	scene.init();
+	scene.init(mode);
 
 	auto& ts = oak::getComponentStorage<TransformComponent>(scene);
 	auto& ds = oak::getComponentStorage<DrawComponent>(scene);
@@ -83,11 +71,11 @@ void oak_bench() {
 	physicsCache.requireComponent<VelocityComponent>();
 	physicsCache.requireComponent<BoxComponent>();
 
-	//create 1048576 entities, add components to entities
+	//create entities, add components to entities
 	start = std::chrono::high_resolution_clock::now();
 
 	oak::EntityId entity;
-	for (size_t i = 0; i < 64000; i++) {
+	for (size_t i = 0; i < count; i++) {
 		entity = scene.createEntity();
 		oak::addComponent<TransformComponent>(entity, scene, oak::Vec2{ 1.0f }, 0.0f, 1.0f);
 		if (i % 2 == 0) {
@@ -101,49 +89,281 @@ void oak_bench() {
 	}	
 
 	end = std::chrono::high_resolution_clock::now();
-	times.push_back({ "oak_create", std::chrono::nanoseconds{ end - start }.count() });
+	times.push_back({ oak::string{ name } + "_create", std::chrono::nanoseconds{ end - start }.count() });
 
+	auto& evtManager = oak::EventManager::inst();
 
 	//iterate
 	start = std::chrono::high_resolution_clock::now();
 	float dt = 1.0f/60.0f;
 	oak::vector<std::pair<oak::Vec2, size_t>> draws;
-	for (size_t i = 0; i < 1024; i++) {
+	for (size_t i = 0; i < frames; i++) {
+		//every mode pays for the cache updates and skips inactive entities
 		drawCache.update(scene);
 		physicsCache.update(scene);
 
-		for (const auto& entity : drawCache.entities()) {
-			auto [tc, dc] = oak::getComponents<const TransformComponent, const DrawComponent>(entity, ts, ds);
-		
-			draws.push_back({ tc.position, dc.spriteId });
-		}
-
-		for (const auto& entity : physicsCache.entities()) {
-			auto [tc, vc, bc] = oak::getComponents<TransformComponent, VelocityComponent, BoxComponent>(entity, ts, vs, bs);
+		if (mode == oak::StorageMode::ARCHETYPE) {
+			//walk the component arrays of each chunk directly
+			auto archetypes = scene.getArchetypes();
+			archetypes->forEachChunk<const TransformComponent, const DrawComponent>([&](size_t n, const oak::EntityId *ids, const TransformComponent *tc, const DrawComponent *dc) {
+				for (size_t j = 0; j < n; j++) {
+					if (!scene.isEntityActive(ids[j])) { continue; }
+					draws.push_back({ tc[j].position, dc[j].spriteId });
+				}
+			});
+			archetypes->forEachChunk<TransformComponent, VelocityComponent, BoxComponent>([&](size_t n, const oak::EntityId *ids, TransformComponent *tc, VelocityComponent *vc, BoxComponent *bc) {
+				for (size_t j = 0; j < n; j++) {
+					if (!scene.isEntityActive(ids[j])) { continue; }
+					if (bc[j].offset.x < bc[j].halfExtent.y) {
+						vc[j].velocity = oak::Vec2{ 0.0f };
+					} else {
+						bc[j].offset.x = bc[j].halfExtent.x + 4.0f;
+						bc[j].offset.y -= 0.02f;
+					}
+					vc[j].velocity += oak::Vec2{ -0.05f, 0.009f };
+					tc[j].position += vc[j].velocity * dt;
+				}
+			});
+		} else {
+			for (const auto& entity : drawCache.entities()) {
+				auto [tc, dc] = oak::getComponents<const TransformComponent, const DrawComponent>(entity, ts, ds);
+			
+				draws.push_back({ tc.position, dc.spriteId });
+			}
 
-			if (bc.offset.x < bc.halfExtent.y) {
-				vc.velocity = oak::Vec2{ 0.0f };
-			} else {
-				bc.offset.x = bc.halfExtent.x + 4.0f;
-				bc.offset.y -= 0.02f;
+			for (const auto& entity : physicsCache.entities()) {
+				auto [tc, vc, bc] = oak::getComponents<TransformComponent, VelocityComponent, BoxComponent>(entity, ts, vs, bs);
+
+				if (bc.offset.x < bc.halfExtent.y) {
+					vc.velocity = oak::Vec2{ 0.0f };
+				} else {
+					bc.offset.x = bc.halfExtent.x + 4.0f;
+					bc.offset.y -= 0.02f;
+				}
+				vc.velocity += oak::Vec2{ -0.05f, 0.009f };
+				tc.position += vc.velocity * dt;
 			}
-			vc.velocity += oak::Vec2{ -0.05f, 0.009f };
-			tc.position += vc.velocity * dt;
 		}
 
 		draws.clear();
 		evtManager.clear();
 	}
 	end = std::chrono::high_resolution_clock::now();
-	times.push_back({ "oak_iterate", std::chrono::nanoseconds{ end - start }.count() / 1024 });
+	times.push_back({ oak::string{ name } + "_iterate", std::chrono::nanoseconds{ end - start }.count() / frames });
 	
 	scene.reset();
+	evtManager.clear();
+	scene.terminate();
+
+}
+
+void oak_cache_bench(size_t count, size_t changes, size_t frames) {
+
+	oak::Scene scene;
+	scene.init();
+
+	oak::EntityCache cache;
+	cache.requireComponent<TransformComponent>();
+
+	oak::vector<oak::EntityId> entities;
+	for (size_t i = 0; i < count; i++) {
+		auto entity = scene.createEntity();
+		oak::addComponent<TransformComponent>(entity, scene, oak::Vec2{ 1.0f }, 0.0f, 1.0f);
+		scene.activateEntity(entity);
+		entities.push_back(entity);
+	}
+
+	auto& evtManager = oak::EventManager::inst();
+	cache.update(scene);
+	evtManager.clear();
+
+	//every frame deactivate a batch of entities and reactivate the previous batch
+	start = std::chrono::high_resolution_clock::now();
+	size_t offset = 0;
+	for (size_t i = 0; i < frames; i++) {
+		size_t next = (offset + changes) % count;
+		for (size_t j = 0; j < changes; j++) {
+			scene.deactivateEntity(entities[(next + j * 7) % count]);
+			scene.activateEntity(entities[(offset + j * 7) % count]);
+		}
+		offset = next;
+		cache.update(scene);
+		evtManager.clear();
+	}
+	end = std::chrono::high_resolution_clock::now();
+	times.push_back({ "oak_cache_update", std::chrono::nanoseconds{ end - start }.count() / frames });
+
+	scene.reset();
+	evtManager.clear();
+	scene.terminate();
+
+}
+
+void oak_query_bench(size_t count, size_t changes, size_t systems, size_t frames) {
+
+	oak::Scene scene;
+	scene.init();
+
+	oak::vector<oak::EntityId> entities;
+	for (size_t i = 0; i < count; i++) {
+		auto entity = scene.createEntity();
+		oak::addComponent<TransformComponent>(entity, scene, oak::Vec2{ 1.0f }, 0.0f, 1.0f);
+		oak::addComponent<VelocityComponent>(entity, scene, oak::Vec2{ 0.0f });
+		scene.activateEntity(entity);
+		entities.push_back(entity);
+	}
+
+	auto& evtManager = oak::EventManager::inst();
+
+	//every system owns a cache with the same filter
+	oak::vector<oak::EntityCache> caches{ systems };
+	for (auto& cache : caches) {
+		cache.requireComponent<TransformComponent>();
+		cache.requireComponent<VelocityComponent>();
+		cache.update(scene);
+	}
+	//every system shares one query
+	for (size_t i = 0; i < systems; i++) {
+		scene.getQuery<TransformComponent, VelocityComponent>();
+	}
+	evtManager.clear();
+
+	auto churn = [&](size_t frame) {
+		for (size_t j = 0; j < changes; j++) {
+			auto entity = entities[(frame * changes + j) % count];
+			scene.deactivateEntity(entity);
+			scene.activateEntity(entity);
+		}
+	};
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < frames; i++) {
+		churn(i);
+		for (auto& cache : caches) {
+			cache.update(scene);
+		}
+		evtManager.clear();
+	}
+	end = std::chrono::high_resolution_clock::now();
+	times.push_back({ "oak_query_private", std::chrono::nanoseconds{ end - start }.count() / frames });
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < frames; i++) {
+		churn(i);
+		scene.update();
+		evtManager.clear();
+	}
+	end = std::chrono::high_resolution_clock::now();
+	times.push_back({ "oak_query_shared", std::chrono::nanoseconds{ end - start }.count() / frames });
+
+	scene.reset();
+	evtManager.clear();
+	scene.terminate();
+
+}
 
+template<class Map, class Key>
+void map_lookup_bench(const char *name, const oak::vector<Key>& keys, size_t lookups) {
+	Map map;
+	for (size_t i = 0; i < keys.size(); i++) {
+		map[keys[i]] = i;
+	}
+
+	volatile size_t sink = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < lookups; i++) {
+		auto it = map.find(keys[(i * 7919) % keys.size()]);
+		sink += it->second;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	times.push_back({ oak::string{ name } + "_" + std::to_string(keys.size()).c_str(), std::chrono::nanoseconds{ end - start }.count() / lookups });
+}
+
+//resource ids and type names against the node based map they replaced
+void map_bench(size_t count, size_t lookups) {
+	oak::vector<size_t> ids;
+	oak::vector<oak::string> names;
+	for (size_t i = 0; i < count; i++) {
+		names.push_back(oak::string{ "resource" } + std::to_string(i).c_str());
+		ids.push_back(std::hash<oak::string>{}(names.back()));
+	}
+
+	map_lookup_bench<oak::unordered_map<size_t, size_t>>("unordered_map_id_lookup", ids, lookups);
+	map_lookup_bench<oak::hash_map<size_t, size_t>>("hash_map_id_lookup", ids, lookups);
+	map_lookup_bench<oak::unordered_map<oak::string, size_t>>("unordered_map_name_lookup", names, lookups);
+	map_lookup_bench<oak::hash_map<oak::string, size_t>>("hash_map_name_lookup", names, lookups);
+}
+
+struct SpriteResource {
+	static const oak::TypeInfo typeInfo;
+	float u, v;
+};
+
+const oak::TypeInfo SpriteResource::typeInfo = oak::makeResourceInfo<SpriteResource>("sprite");
+
+void pup(oak::Puper& puper, SpriteResource& data, const oak::ObjInfo& info) {}
+
+//per entity resource access, by name against cached handles
+void resource_bench(size_t count, size_t entities) {
+	oak::ResourceManager resManager;
+	oak::vector<oak::string> names;
+	for (size_t i = 0; i < count; i++) {
+		names.push_back(oak::string{ "sprite" } + std::to_string(i).c_str());
+		oak::addResource<SpriteResource>(names.back(), static_cast<float>(i), 0.0f);
+	}
+	oak::vector<oak::Resource<SpriteResource>> handles;
+	for (size_t i = 0; i < entities; i++) {
+		handles.emplace_back(names[(i * 7919) % count]);
+	}
+
+	volatile float sink = 0.0f;
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < entities; i++) {
+		sink += oak::requireResource<SpriteResource>(names[(i * 7919) % count]).u;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	times.push_back({ "resource_by_name", std::chrono::nanoseconds{ end - start }.count() / entities });
+
+	//the first pass resolves the handles
+	for (const auto& handle : handles) {
+		sink += handle->u;
+	}
+	start = std::chrono::high_resolution_clock::now();
+	for (const auto& handle : handles) {
+		sink += handle->u;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	times.push_back({ "resource_by_handle", std::chrono::nanoseconds{ end - start }.count() / entities });
 }
 
 int main(int argc, char **argv) {
 
-	oak_bench();
+	oak::EventManager evtManager;
+	
+	oak::addEventQueue<oak::EntityCreateEvent>();
+	oak::addEventQueue<oak::EntityDestroyEvent>();
+	oak::addEventQueue<oak::EntityActivateEvent>();
+	oak::addEventQueue<oak::EntityDeactivateEvent>();
+
+	oak::ComponentTypeManager ctm;
+
+	ctm.addType<TransformComponent>();
+	ctm.addType<DrawComponent>();
+	ctm.addType<VelocityComponent>();
+	ctm.addType<BoxComponent>();
+
+	oak_bench("oak", 64000, 1024, oak::StorageMode::POOL);
+	oak_bench("oak_pool_100k", 100000, 64, oak::StorageMode::POOL);
+	oak_bench("oak_sparse_100k", 100000, 64, oak::StorageMode::SPARSE);
+	oak_bench("oak_archetype_100k", 100000, 64, oak::StorageMode::ARCHETYPE);
+	oak_bench("oak_pool_1m", 1000000, 8, oak::StorageMode::POOL);
+	oak_bench("oak_sparse_1m", 1000000, 8, oak::StorageMode::SPARSE);
+	oak_bench("oak_archetype_1m", 1000000, 8, oak::StorageMode::ARCHETYPE);
+	oak_cache_bench(100000, 10000, 64);
+	oak_query_bench(100000, 10000, 8, 64);
+	map_bench(1000, 10000000);
+	map_bench(100000, 10000000);
+	resource_bench(1000, 1000000);
 
 	for (auto& t : times) {
 		printf("%s: %lins\n", t.first.c_str(), t.second);
@@ -1,5 +1,8 @@
 #include <iostream>
+#include <cstdio>
+#include <cstring>
 #include <util/byte_buffer.h>
+#include <util/mapped_buffer.h>
 #include <oak_alloc.h>
 
 int main(int argc, char **argv) {
@@ -35,6 +38,36 @@ int main(int argc, char **argv) {
 		return 1;
 	}
 
+	//the same data read back in place from a mapped file
+	FILE *file = fopen("buffer_test.bin", "wb");
+	fwrite(buffer.data(), 1, buffer.pos(), file);
+	fclose(file);
+
+	{
+		oak::MappedBuffer mapped{ "buffer_test.bin" };
+		if (!mapped.isValid() || mapped.size() != buffer.pos() || memcmp(mapped.data(), buffer.data(), mapped.size()) != 0) {
+			return 1;
+		}
+		oak::Stream mstream{ &mapped };
+		if (mstream.read<int32_t>() != i32 || mstream.read<uint64_t>() != u64) {
+			return 1;
+		}
+		//take returns a pointer into the mapping
+		const char *ptr = mapped.take(sizeof(int16_t));
+		if (ptr != mapped.data() + sizeof(int32_t) + sizeof(uint64_t) || memcmp(ptr, &i16, sizeof(i16)) != 0) {
+			return 1;
+		}
+		mapped.rewind();
+		if (mapped.take(mapped.size() + 1) != nullptr || mapped.write(sizeof(i32), &i32) != 0) {
+			return 1;
+		}
+	}
+	remove("buffer_test.bin");
+
+	if (oak::MappedBuffer{ "buffer_test.bin" }.isValid()) {
+		return 1;
+	}
+
 	return 0;
 
 }
\ No newline at end of file
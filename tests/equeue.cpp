@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <event_queue.h>
 #include <event.h>
 #include <oakengine.h>
@@ -13,40 +14,186 @@ struct TEvent {
 
 const oak::TypeInfo TEvent::typeInfo = oak::makeEventInfo<TEvent>("tevent");
 
-void pup(oak::Puper& puper, TEvent& data, const oak::ObjInfo& info) {}
+//events with sizes that do not divide a page evenly
+struct SmallEvent {
+	static const oak::TypeInfo typeInfo;
 
-int main(int argc, char **argv) {
+	uint8_t bytes[3];
+};
 
-	oak::EventManager evtManager;
-	oak::EventTypeManager etm;
+const oak::TypeInfo SmallEvent::typeInfo = oak::makeEventInfo<SmallEvent>("small_event");
 
-	etm.addType<TEvent>();
+struct LargeEvent {
+	static const oak::TypeInfo typeInfo;
 
-	evtManager.init();
+	uint32_t index;
+	uint8_t bytes[1013];
+};
+
+const oak::TypeInfo LargeEvent::typeInfo = oak::makeEventInfo<LargeEvent>("large_event");
+
+struct DEvent {
+	static const oak::TypeInfo typeInfo;
+
+	size_t frame;
+};
+
+const oak::TypeInfo DEvent::typeInfo = oak::makeEventInfo<DEvent>("devent");
+
+void pup(oak::Puper& puper, TEvent& data, const oak::ObjInfo& info) {}
+void pup(oak::Puper& puper, DEvent& data, const oak::ObjInfo& info) {}
+void pup(oak::Puper& puper, SmallEvent& data, const oak::ObjInfo& info) {}
+void pup(oak::Puper& puper, LargeEvent& data, const oak::ObjInfo& info) {}
 
+constexpr size_t EVENT_COUNT = 1000000;
+
+int checkEvents() {
 	auto& queue = oak::getEventQueue<TEvent>();
 
-	for (size_t i = 0; i < 1024; i++) {
-		oak::emitEvent<TEvent>(i * i * i, i, static_cast<uint8_t>(i) % 255);
+	for (size_t i = 0; i < EVENT_COUNT; i++) {
+		oak::emitEvent<TEvent>(i * i * i, i, static_cast<uint8_t>(i % 255));
 	}
 
-	printf("size: %lu\n", queue.size);
+	printf("size: %lu\n", queue.size());
+	if (queue.size() != EVENT_COUNT) { return -1; }
 
 	size_t i = 0;
-	{
-		for (auto& event : queue) {
-			if (event.size != (i * i * i) || event.index != i || event.byte != i % 255) {
-				printf("i: %lu, size: %lu\n", i, event.size);
-				return -1;
+	for (auto& event : queue) {
+		if (event.size != (i * i * i) || event.index != i || event.byte != i % 255) {
+			printf("i: %lu, size: %lu\n", i, event.size);
+			return -1;
+		}
+		i++;
+	}
+	if (i != EVENT_COUNT) { return -1; }
+
+	//random access
+	for (size_t j = 0; j < EVENT_COUNT; j += 4099) {
+		if (queue[j].index != j || (queue.begin() + j)->index != j || queue.begin()[j].index != j) {
+			printf("index: %lu\n", j);
+			return -1;
+		}
+	}
+	if (queue.end() - queue.begin() != static_cast<ptrdiff_t>(EVENT_COUNT)) { return -1; }
+	auto it = std::lower_bound(queue.begin(), queue.end(), 777777, [](const TEvent& event, size_t index) {
+		return event.index < index;
+	});
+	if (it->index != 777777) { return -1; }
+
+	queue.clear();
+	if (!queue.empty() || queue.begin() != queue.end()) { return -1; }
+
+	return 0;
+}
+
+int checkSmallEvents() {
+	auto& queue = oak::getEventQueue<SmallEvent>();
+
+	for (size_t i = 0; i < EVENT_COUNT; i++) {
+		oak::emitEvent<SmallEvent>(SmallEvent{ { static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i >> 16) } });
+	}
+
+	size_t i = 0;
+	for (auto& event : queue) {
+		size_t value = event.bytes[0] | (event.bytes[1] << 8) | (event.bytes[2] << 16);
+		if (value != i) {
+			printf("small i: %lu, value: %lu\n", i, value);
+			return -1;
+		}
+		i++;
+	}
+	if (i != EVENT_COUNT) { return -1; }
+
+	queue.clear();
+	return 0;
+}
+
+int checkLargeEvents() {
+	auto& queue = oak::getEventQueue<LargeEvent>();
+
+	//mix single emits with bulk emits that cross page boundaries
+	oak::vector<LargeEvent> batch(37);
+	size_t index = 0;
+	while (index < EVENT_COUNT) {
+		if (index % 3 == 0) {
+			LargeEvent event;
+			event.index = static_cast<uint32_t>(index);
+			event.bytes[1012] = static_cast<uint8_t>(index);
+			queue.emit(event);
+			index++;
+		} else {
+			size_t count = std::min(batch.size(), EVENT_COUNT - index);
+			for (size_t j = 0; j < count; j++) {
+				batch[j].index = static_cast<uint32_t>(index + j);
+				batch[j].bytes[1012] = static_cast<uint8_t>(index + j);
 			}
-			i++;
+			queue.emitN(batch.data(), count);
+			index += count;
 		}
+	}
 
-		printf("done\ni: %lu\n", i);
+	if (queue.size() != EVENT_COUNT) { return -1; }
+	for (size_t i = 0; i < EVENT_COUNT; i++) {
+		if (queue[i].index != i || queue[i].bytes[1012] != static_cast<uint8_t>(i)) {
+			printf("large i: %lu, index: %u\n", i, queue[i].index);
+			return -1;
+		}
 	}
 
 	queue.clear();
+	LargeEvent event;
+	event.index = 5;
+	queue.emitN(1000, event);
+	for (auto& e : queue) {
+		if (e.index != 5) { return -1; }
+	}
+	if (queue.size() != 1000) { return -1; }
+	queue.clear();
+
+	return 0;
+}
+
+int checkDoubleBuffered() {
+	auto& evtManager = oak::EventManager::inst();
+	auto& queue = oak::getEventQueue<DEvent>();
+
+	for (size_t frame = 0; frame < 4; frame++) {
+		//events emitted this frame are only readable next frame
+		for (auto& event : queue) {
+			if (event.frame + 1 != frame) {
+				printf("frame: %lu, event frame: %lu\n", frame, event.frame);
+				return -1;
+			}
+		}
+		if (queue.size() != (frame == 0 ? 0 : 100)) { return -1; }
+		for (size_t i = 0; i < 100; i++) {
+			oak::emitEvent<DEvent>(frame);
+		}
+		if (queue.size() != (frame == 0 ? 0 : 100)) { return -1; }
+		evtManager.clear();
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv) {
+
+	oak::EventManager evtManager;
+	oak::EventTypeManager etm;
+
+	etm.addType<TEvent>();
+	etm.addType<SmallEvent>();
+
+	evtManager.init();
+	//a million kilobyte events do not fit in the default reservation
+	oak::addEventQueue<LargeEvent>(false, size_t{ 1 } << 31);
+	oak::addEventQueue<DEvent>(true);
+
+	if (checkEvents() != 0 || checkSmallEvents() != 0 || checkLargeEvents() != 0 || checkDoubleBuffered() != 0) {
+		return -1;
+	}
 
+	printf("done\n");
 
 	return 0;
 
@@ -0,0 +1,80 @@
+#include <thread>
+#include <event_queue.h>
+#include <event.h>
+#include <oakengine.h>
+#include <log.h>
+
+struct TEvent {
+	static const oak::TypeInfo typeInfo;
+
+	size_t thread = 0;
+	size_t index = 0;
+};
+
+const oak::TypeInfo TEvent::typeInfo = oak::makeEventInfo<TEvent>("tevent");
+
+void pup(oak::Puper& puper, TEvent& data, const oak::ObjInfo& info) {}
+
+constexpr size_t THREAD_COUNT = 8;
+constexpr size_t EVENT_COUNT = 1000000; //per frame across all threads
+constexpr size_t FRAME_COUNT = 4;
+
+int main(int argc, char **argv) {
+
+	oak::EventManager evtManager;
+	oak::EventTypeManager etm;
+
+	etm.addType<TEvent>();
+
+	evtManager.init();
+
+	auto& queue = oak::getEventQueue<TEvent>();
+
+	for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+		//the main thread emits alongside the workers
+		oak::vector<std::thread> threads;
+		for (size_t t = 1; t < THREAD_COUNT; t++) {
+			threads.emplace_back([t]() {
+				for (size_t i = t; i < EVENT_COUNT; i += THREAD_COUNT) {
+					oak::emitEvent<TEvent>(t, i);
+				}
+			});
+		}
+		for (size_t i = 0; i < EVENT_COUNT; i += THREAD_COUNT) {
+			oak::emitEvent<TEvent>(size_t{ 0 }, i);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		evtManager.flush();
+
+		if (queue.size() != EVENT_COUNT) {
+			printf("frame: %lu, size: %lu\n", frame, queue.size());
+			return -1;
+		}
+
+		//every index should be seen exactly once and events from one thread stay in order
+		oak::vector<bool> seen(EVENT_COUNT, false);
+		oak::vector<size_t> last(THREAD_COUNT, 0);
+		for (auto& event : queue) {
+			if (event.index >= EVENT_COUNT || seen[event.index] || event.index % THREAD_COUNT != event.thread) {
+				printf("frame: %lu, bad event thread: %lu, index: %lu\n", frame, event.thread, event.index);
+				return -1;
+			}
+			if (event.index < last[event.thread]) {
+				printf("frame: %lu, out of order event thread: %lu, index: %lu\n", frame, event.thread, event.index);
+				return -1;
+			}
+			seen[event.index] = true;
+			last[event.thread] = event.index;
+		}
+
+		evtManager.clear();
+	}
+
+	printf("done\n");
+
+	return 0;
+
+}
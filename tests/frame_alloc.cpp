@@ -0,0 +1,145 @@
+#include <thread>
+#include <cstring>
+#include <oak_alloc.h>
+#include <frame_channel.h>
+#include <container.h>
+
+constexpr size_t THREAD_COUNT = 8;
+constexpr size_t ALLOC_COUNT = 20000; //per thread per frame
+constexpr size_t FRAME_COUNT = 8;
+
+//a frame allocation filled by one thread and read by another
+struct Message {
+	size_t thread;
+	size_t index;
+	size_t size;
+	const uint8_t *data;
+};
+
+int main(int argc, char **argv) {
+
+	oak::FrameChannel<Message> channel;
+
+	for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+		oak::vector<std::thread> threads;
+		for (size_t t = 0; t < THREAD_COUNT; t++) {
+			threads.emplace_back([t, &channel]() {
+				for (size_t i = 0; i < ALLOC_COUNT; i++) {
+					size_t size = 1 + (i * 7 + t) % 200;
+					auto data = static_cast<uint8_t*>(oak::oalloc_frame.allocate(size));
+					std::memset(data, static_cast<int>(t * 31 + i), size);
+					channel.send(Message{ t, i, size, data });
+				}
+			});
+		}
+
+		//receive while the producers are still running
+		oak::vector<size_t> next(THREAD_COUNT, 0);
+		size_t received = 0;
+		auto check = [&](const Message& msg) {
+			if (msg.index != next[msg.thread]) {
+				printf("frame: %lu, thread: %lu, expected index: %lu, got: %lu\n", frame, msg.thread, next[msg.thread], msg.index);
+				exit(-1);
+			}
+			next[msg.thread]++;
+			for (size_t i = 0; i < msg.size; i++) {
+				if (msg.data[i] != static_cast<uint8_t>(msg.thread * 31 + msg.index)) {
+					printf("frame: %lu, thread: %lu, index: %lu, corrupted data\n", frame, msg.thread, msg.index);
+					exit(-1);
+				}
+			}
+			received++;
+		};
+		while (received < THREAD_COUNT * ALLOC_COUNT / 2) {
+			channel.receive(check);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		channel.receive(check);
+
+		if (received != THREAD_COUNT * ALLOC_COUNT) {
+			printf("frame: %lu, received: %lu\n", frame, received);
+			return -1;
+		}
+
+		oak::oalloc_frame.clear();
+	}
+
+	//allocations larger than a page are contiguous
+	constexpr size_t LARGE_SIZE = 8000000;
+	auto large = static_cast<uint8_t*>(oak::oalloc_frame.allocate(LARGE_SIZE));
+	std::memset(large, 0xab, LARGE_SIZE);
+	oak::oalloc_frame.clear();
+
+	//the pages committed for a spike are released by the next clear that uses far less
+	{
+		oak::VirtualArena arena{ 64000000 };
+		std::memset(arena.allocate(LARGE_SIZE), 1, LARGE_SIZE);
+		arena.clear();
+		if (arena.getCommitted() < LARGE_SIZE) {
+			printf("committed: %lu, expected at least: %lu\n", arena.getCommitted(), LARGE_SIZE);
+			return -1;
+		}
+		std::memset(arena.allocate(64), 2, 64);
+		arena.clear();
+		if (arena.getCommitted() >= LARGE_SIZE) {
+			printf("committed: %lu after the spike\n", arena.getCommitted());
+			return -1;
+		}
+		//trimmed pages can be committed again
+		std::memset(arena.allocate(LARGE_SIZE), 3, LARGE_SIZE);
+	}
+
+	//scoped arenas give back everything allocated in them when they end
+	{
+		auto& stack = oak::oalloc_scratch();
+		const size_t marker = stack.getMarker();
+		{
+			oak::ScopedArena scratch;
+			oak::vector<oak::string> strings{ scratch.allocator<oak::string>() };
+			for (size_t i = 0; i < 1000; i++) {
+				strings.push_back(oak::string(100, static_cast<char>('a' + i % 26)));
+			}
+			size_t inner;
+			{
+				oak::ScopedArena nested;
+				std::memset(nested.allocate(LARGE_SIZE), 0xcd, LARGE_SIZE);
+				inner = stack.getMarker();
+			}
+			if (stack.getMarker() >= inner) {
+				printf("nested arena was not rolled back\n");
+				return -1;
+			}
+			for (size_t i = 0; i < strings.size(); i++) {
+				if (strings[i] != oak::string(100, static_cast<char>('a' + i % 26))) {
+					printf("scratch string %lu corrupted\n", i);
+					return -1;
+				}
+			}
+		}
+		if (stack.getMarker() != marker) {
+			printf("scratch marker: %lu, expected: %lu\n", stack.getMarker(), marker);
+			return -1;
+		}
+	}
+
+	//freeing in reverse order releases every allocation even with alignment padding between them
+	{
+		oak::StackAllocator stack{ 1 << 20, 16 };
+		void *a = stack.allocate(5);
+		void *b = stack.allocate(24);
+		void *c = stack.allocate(3);
+		stack.deallocate(c, 3);
+		stack.deallocate(b, 24);
+		stack.deallocate(a, 5);
+		if (stack.getMarker() != 0) {
+			printf("lifo frees left %lu bytes on the stack\n", stack.getMarker());
+			return -1;
+		}
+	}
+
+	printf("done\n");
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <unordered_map>
+#include <string>
+#include <container.h>
+
+struct Random {
+	uint32_t seed;
+
+	uint32_t operator()() {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+};
+
+//every key hashes to the same home slot
+struct CollidingHash {
+	size_t operator()(size_t) const { return 0; }
+};
+
+template<class Map, class Ref>
+bool matches(const Map& map, const Ref& ref) {
+	if (map.size() != ref.size()) {
+		printf("size: %lu, expected: %lu\n", map.size(), ref.size());
+		return false;
+	}
+	for (const auto& it : ref) {
+		auto found = map.find(it.first);
+		if (found == map.end() || found->second != it.second) {
+			printf("missing or wrong value\n");
+			return false;
+		}
+	}
+	size_t count = 0;
+	for (const auto& it : map) {
+		if (ref.count(it.first) == 0) {
+			printf("unexpected key\n");
+			return false;
+		}
+		count++;
+	}
+	return count == ref.size();
+}
+
+int main(int argc, char **argv) {
+
+	//random inserts and erases against the standard map
+	{
+		oak::hash_map<size_t, size_t> map;
+		std::unordered_map<size_t, size_t> ref;
+		Random random{ 2463534242u };
+		for (size_t i = 0; i < 200000; i++) {
+			size_t key = random() % 5000;
+			switch (random() % 4) {
+				case 0:
+					map.erase(key);
+					ref.erase(key);
+					break;
+				case 1: {
+					auto it = map.find(key);
+					if (it != map.end()) {
+						map.erase(it);
+					}
+					ref.erase(key);
+				} break;
+				default:
+					map[key] = i;
+					ref[key] = i;
+					break;
+			}
+		}
+		if (!matches(map, ref)) { return -1; }
+
+		//copies and moves keep the contents
+		auto copy = map;
+		auto moved = std::move(map);
+		if (!matches(copy, ref) || !matches(moved, ref) || !map.empty()) {
+			printf("copy or move lost entries\n");
+			return -1;
+		}
+		moved.clear();
+		if (!moved.empty() || moved.find(1) != moved.end()) {
+			printf("clear left entries\n");
+			return -1;
+		}
+	}
+
+	//string keys
+	{
+		oak::hash_map<oak::string, size_t> map;
+		for (size_t i = 0; i < 1000; i++) {
+			auto result = map.insert({ oak::string{ "resource" } + std::to_string(i).c_str(), i });
+			if (!result.second || result.first->second != i) {
+				printf("failed to insert string key\n");
+				return -1;
+			}
+		}
+		if (map.insert({ "resource10", 0 }).second || map["resource10"] != 10 || map.count("resource1000") != 0) {
+			printf("wrong string lookup\n");
+			return -1;
+		}
+		//the oak string hash is the same as the std string hash, resource ids are stored in files
+		if (std::hash<oak::string>{}("resource10") != std::hash<std::string>{}("resource10")) {
+			printf("string hash changed\n");
+			return -1;
+		}
+	}
+
+	//every key probes from the same slot
+	{
+		oak::hash_map<size_t, size_t, CollidingHash> map;
+		for (size_t i = 0; i < 1000; i++) {
+			if (map[i] != 0) {
+				printf("colliding key already present\n");
+				return -1;
+			}
+			map[i] = i + 1;
+		}
+		for (size_t i = 0; i < 1000; i += 2) {
+			map.erase(i);
+		}
+		for (size_t i = 0; i < 1000; i++) {
+			auto it = map.find(i);
+			if ((i % 2 == 0) != (it == map.end()) || (it != map.end() && it->second != i + 1)) {
+				printf("colliding key %lu has the wrong value\n", i);
+				return -1;
+			}
+		}
+	}
+
+	printf("done\n");
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <experimental/filesystem>
+#include <resource_reloader.h>
+#include <file_manager.h>
+#include <oakengine.h>
+
+struct Shader {
+	static const oak::TypeInfo typeInfo;
+	int version;
+};
+
+const oak::TypeInfo Shader::typeInfo = oak::makeResourceInfo<Shader>("shader");
+
+struct Material {
+	static const oak::TypeInfo typeInfo;
+	int shaderVersion;
+	int loads;
+};
+
+const oak::TypeInfo Material::typeInfo = oak::makeResourceInfo<Material>("material");
+
+void pup(oak::Puper& puper, Shader& data, const oak::ObjInfo& info) {}
+void pup(oak::Puper& puper, Material& data, const oak::ObjInfo& info) {}
+
+int materialLoads = 0;
+
+void writeFile(const char *path, int value) {
+	FILE *file = fopen(path, "w");
+	fprintf(file, "%i", value);
+	fclose(file);
+}
+
+int readFile(const oak::string& path) {
+	//decoding reads a copy, the file can be rewritten while a reload reads it
+	auto buffer = oak::FileManager::inst().readFile(path);
+	return atoi(oak::string{ buffer.data(), buffer.size() }.c_str());
+}
+
+//runs frames until the condition holds, a frame is at least a millisecond
+template<class F>
+bool frames(oak::ResourceReloader& reloader, oak::ResourceLoader& loader, F&& condition, int count = 1000) {
+	for (int i = 0; i < count; i++) {
+		reloader.update();
+		loader.update();
+		if (condition()) { return true; }
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+	}
+	return false;
+}
+
+int main(int argc, char **argv) {
+
+	std::experimental::filesystem::create_directory("hot_reload");
+	writeFile("hot_reload/basic.shader", 1);
+
+	oak::FileManager fm;
+	fm.mount("{$cwd}/hot_reload", "/res");
+
+	oak::ResourceManager resManager;
+	oak::ResourceLoader loader{ 1 };
+	oak::ResourceReloader reloader;
+
+	oak::setDefaultResource<Shader>(0);
+	oak::setDefaultResource<Material>(0, 0);
+
+	auto shader = reloader.load<Shader>("basic", { "/res/basic.shader" }, []() { return Shader{ readFile("/res/basic.shader") }; });
+	//the material is built from its shader on the main thread so it is rebuilt after the shader is reloaded
+	auto material = reloader.load<Material>("basic", {}, []() { return 0; }, [](int&) {
+		return Material{ oak::requireResource<Shader>("basic").version, ++materialLoads };
+	});
+	reloader.addDependency<Material, Shader>("basic", "basic");
+
+	loader.finish();
+	if (shader->version != 1 || material->loads != 1) {
+		printf("initial load failed\n");
+		return -1;
+	}
+
+	//rebuild the material with the loaded shader
+	reloader.reload<Material>("basic");
+	if (!frames(reloader, loader, [&]() { return material->loads == 2; }) || material->shaderVersion != 1) {
+		printf("manual reload failed\n");
+		return -1;
+	}
+
+	//the shader changes on disk, the material is reloaded after it
+	const auto before = shader.get();
+	writeFile("hot_reload/basic.shader", 2);
+	if (!frames(reloader, loader, [&]() { return material->loads == 3 && !reloader.isReloading(); })) {
+		printf("file change was not picked up\n");
+		return -1;
+	}
+	if (shader->version != 2 || material->shaderVersion != 2 || shader.get() != before) {
+		printf("reload used the old shader, shader: %i, material: %i\n", shader->version, material->shaderVersion);
+		return -1;
+	}
+
+	//a file that cannot be read gives an empty buffer instead of aborting the loader thread
+	if (!fm.readFile("/res/missing.shader").empty()) {
+		printf("missing file was read\n");
+		return -1;
+	}
+
+	//files that no resource was loaded from are ignored
+	writeFile("hot_reload/other.txt", 3);
+	frames(reloader, loader, []() { return false; }, 50);
+	if (material->loads != 3) {
+		printf("unrelated file triggered a reload\n");
+		return -1;
+	}
+
+	std::experimental::filesystem::remove_all("hot_reload");
+
+	printf("done\n");
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <scene_events.h>
+#include <oakengine.h>
+#include <entity_id.h>
+#include <entity_cache.h>
+#include <job_manager.h>
+#include <system_manager.h>
+#include <container.h>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+
+struct TransformComponent {
+	static const oak::TypeInfo typeInfo;
+	oak::Vec2 position;
+	float rotation;
+	float scale;
+};
+
+const oak::TypeInfo TransformComponent::typeInfo = oak::makeComponentInfo<TransformComponent>("transform");
+
+struct VelocityComponent {
+	static const oak::TypeInfo typeInfo;
+	oak::Vec2 velocity;
+	oak::Vec2 acceleration;
+};
+
+const oak::TypeInfo VelocityComponent::typeInfo = oak::makeComponentInfo<VelocityComponent>("velocity");
+
+void pup(oak::Puper& puper, TransformComponent& data, const oak::ObjInfo& info) {}
+void pup(oak::Puper& puper, VelocityComponent& data, const oak::ObjInfo& info) {}
+
+//records the order systems ran in, declares no access so it conflicts with every other system
+struct OrderSystem : oak::System {
+	OrderSystem(std::atomic<int> *counter, int *ran) : counter{ counter }, ran{ ran } {}
+	void run() override { *ran = (*counter)++; }
+
+	std::atomic<int> *counter;
+	int *ran;
+};
+
+constexpr size_t ENTITY_COUNT = 200000;
+constexpr size_t FRAMES = 64;
+constexpr size_t PARALLEL_COUNT = 1 << 22;
+constexpr size_t STRESS_ROUNDS = 512;
+constexpr size_t STRESS_PAIRS = 300;
+
+//integrates every entity in the cache using the given number of threads, returns the average frame time
+size_t integrate(oak::Scene& scene, const oak::EntityCache& cache, size_t threads) {
+	oak::JobManager jobManager{ threads };
+
+	const float dt = 1.0f / 60.0f;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < FRAMES; i++) {
+		oak::parallelForEach<TransformComponent, VelocityComponent>(cache, scene, [dt](oak::EntityId, TransformComponent& tc, VelocityComponent& vc) {
+			tc.position += vc.velocity * dt + vc.acceleration * (0.5f * dt * dt);
+			tc.rotation += vc.velocity.x * dt;
+			vc.velocity += vc.acceleration * dt;
+		});
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::nanoseconds{ end - start }.count() / FRAMES;
+}
+
+int main(int argc, char **argv) {
+
+	oak::EventManager evtManager;
+
+	oak::addEventQueue<oak::EntityCreateEvent>();
+	oak::addEventQueue<oak::EntityDestroyEvent>();
+	oak::addEventQueue<oak::EntityActivateEvent>();
+	oak::addEventQueue<oak::EntityDeactivateEvent>();
+
+	oak::ComponentTypeManager ctm;
+	ctm.addType<TransformComponent>();
+	ctm.addType<VelocityComponent>();
+
+	oak::Scene scene;
+	scene.init();
+
+	for (size_t i = 0; i < ENTITY_COUNT; i++) {
+		auto entity = scene.createEntity();
+		oak::addComponent<TransformComponent>(entity, scene, oak::Vec2{ 0.0f }, 0.0f, 1.0f);
+		oak::addComponent<VelocityComponent>(entity, scene, oak::Vec2{ 1.0f, 0.5f }, oak::Vec2{ 0.0f, 9.8f });
+		scene.activateEntity(entity);
+	}
+
+	const auto& cache = scene.getQuery<TransformComponent, VelocityComponent>();
+	evtManager.clear();
+	if (cache.entities().size() != ENTITY_COUNT) {
+		printf("expected %lu entities, got %lu\n", ENTITY_COUNT, cache.entities().size());
+		return 1;
+	}
+
+	//thread counts past the number of cores would only measure oversubscription
+	const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+	printf("oak_parallel_cores: %lu\n", cores);
+	size_t single = 0, runs = 0;
+	for (size_t threads = 1; threads <= 8 && threads <= cores; threads *= 2) {
+		size_t time = integrate(scene, cache, threads);
+		if (threads == 1) { single = time; }
+		printf("oak_parallel_integrate_%lu: %lins (%.2fx)\n", threads, time, static_cast<double>(single) / time);
+		runs++;
+	}
+
+	//every entity should have been integrated once per frame per run
+	auto& tc = oak::getComponent<const TransformComponent>(cache.entities()[0], scene);
+	const float expected = static_cast<float>(runs) * FRAMES / 60.0f;
+	if (tc.position.x < expected * 0.99f || tc.position.x > expected * 1.01f) {
+		printf("integration mismatch: %f != %f\n", tc.position.x, expected);
+		return 1;
+	}
+
+	{
+		oak::JobManager jobManager{ 4 };
+
+		//far more chunks than the job pool holds, the chunks are grown instead of wrapping over live jobs
+		std::atomic<size_t> sum{ 0 };
+		jobManager.parallelFor(PARALLEL_COUNT, 1, [&sum](size_t begin, size_t end) {
+			size_t local = 0;
+			for (size_t i = begin; i < end; i++) { local += i; }
+			sum += local;
+		});
+		if (sum != PARALLEL_COUNT * (PARALLEL_COUNT - 1) / 2) {
+			printf("parallel for missed indices\n");
+			return 1;
+		}
+
+		//wrap the job ring many times with continuations while the workers are still finishing the jobs of earlier rounds
+		std::atomic<size_t> ran{ 0 };
+		for (size_t round = 0; round < STRESS_ROUNDS; round++) {
+			oak::Job *root = jobManager.create(nullptr);
+			for (size_t i = 0; i < STRESS_PAIRS; i++) {
+				oak::Job *job = jobManager.create([&ran]() { ran++; }, root);
+				oak::Job *continuation = jobManager.create([&ran]() { ran++; }, root);
+				jobManager.addContinuation(job, continuation);
+				jobManager.run(continuation);
+				jobManager.run(job);
+			}
+			jobManager.run(root);
+			jobManager.wait(root);
+		}
+		if (ran != STRESS_ROUNDS * STRESS_PAIRS * 2) {
+			printf("jobs were lost when the ring wrapped, ran %lu of %lu\n", ran.load(), STRESS_ROUNDS * STRESS_PAIRS * 2);
+			return 1;
+		}
+
+		//an explicit dependency on a later system orders the conflicting pair instead of forming a cycle
+		oak::SystemManager sysManager;
+		std::atomic<int> counter{ 0 };
+		int first = -1, second = -1;
+		OrderSystem a{ &counter, &first }, b{ &counter, &second };
+		sysManager.addSystem(&a, 0);
+		sysManager.addSystem(&b, 1);
+		sysManager.addDependency(0, 1);
+		sysManager.run();
+		if (second != 0 || first != 1) {
+			printf("systems ran in the wrong order, first: %i, second: %i\n", first, second);
+			return 1;
+		}
+		sysManager.clear();
+	}
+
+	scene.reset();
+	evtManager.clear();
+	scene.terminate();
+
+	return 0;
+}
@@ -28,6 +28,32 @@ int main(int argc, char **argv) {
 	printf("r: %p, res: %p\n", &r, &res);
 	printf("x: %f\n", res.x);
 
+	//handles resolve to the same resource across reloads and go stale when it is removed
+	oak::setDefaultResource<Res>(oak::vector<int>{}, 0.0f, 0.0f);
+	oak::Resource<Res> handle{ "mamoth" };
+	if (handle->x != -1.0f) {
+		printf("handle resolved to the wrong resource\n");
+		return 1;
+	}
+	auto& storage = oak::ResourceManager::inst().get(&Res::typeInfo);
+	const auto first = storage.getHandle(handle.id);
+	oak::addResource<Res>("mamoth", oak::vector<int>{ 1 }, 2.0f, 3.0f);
+	const auto reloaded = storage.getHandle(handle.id);
+	if (handle->x != 2.0f || first.index != reloaded.index || first.generation != reloaded.generation) {
+		printf("reload changed the handle\n");
+		return 1;
+	}
+	storage.remove(handle.id);
+	if (storage.resolve(reloaded) != nullptr || handle->x != 0.0f) {
+		printf("stale handle still resolves\n");
+		return 1;
+	}
+	oak::addResource<Res>("mamoth", oak::vector<int>{ 4 }, 5.0f, 6.0f);
+	if (handle->x != 5.0f || storage.getHandle(handle.id).generation == reloaded.generation) {
+		printf("handle did not pick up the new resource\n");
+		return 1;
+	}
+
 
 	return 0;
 }
@@ -0,0 +1,96 @@
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <resource_loader.h>
+#include <oakengine.h>
+
+struct Res {
+	static const oak::TypeInfo typeInfo;
+
+	oak::vector<int> list;
+	float value;
+};
+
+const oak::TypeInfo Res::typeInfo = oak::makeResourceInfo<Res>("res");
+
+void pup(oak::Puper& puper, Res& data, const oak::ObjInfo& info) {}
+
+std::atomic<bool> blocked{ true };
+//a std vector so it does not outlive the oak allocators
+std::vector<int> decodeOrder;
+
+int main(int argc, char **argv) {
+
+	oak::ResourceManager resManager;
+	//one thread so the decode order is deterministic
+	oak::ResourceLoader loader{ 1 };
+
+	oak::setDefaultResource<Res>(oak::vector<int>{}, -1.0f);
+
+	//holds the loader thread until the other loads are queued
+	auto blocker = loader.load<Res>("blocker", 0, []() {
+		while (blocked) { std::this_thread::yield(); }
+		return Res{ {}, 0.0f };
+	});
+
+	auto low = loader.load<Res>("low", 1, []() { decodeOrder.push_back(1); return Res{ { 1 }, 1.0f }; });
+	auto high = loader.load<Res>("high", 5, []() { decodeOrder.push_back(5); return Res{ { 5 }, 5.0f }; });
+	auto cancelled = loader.load<Res>("cancelled", 10, []() { decodeOrder.push_back(10); return Res{ { 10 }, 10.0f }; });
+	//decode produces an intermediate value that is turned into the resource when it is published
+	auto created = loader.load<Res>("created", 3, []() { decodeOrder.push_back(3); return 3; }, [](int& value) {
+		return Res{ { value }, static_cast<float>(value) };
+	});
+	//a second load of a pending resource raises its priority instead of loading it again
+	loader.load<Res>("low", 4, []() { decodeOrder.push_back(-1); return Res{ {}, -1.0f }; });
+
+	//handles point at the default resource until the load is published
+	if (low->value != -1.0f || !loader.isLoading<Res>("low")) {
+		printf("pending handle does not point at the default resource\n");
+		return -1;
+	}
+
+	if (!loader.cancel<Res>("cancelled") || loader.cancel<Res>("missing") || loader.isLoading<Res>("cancelled")) {
+		printf("failed to cancel\n");
+		return -1;
+	}
+
+	blocked = false;
+	//nothing is published until update is called
+	while (loader.isLoading<Res>("low") && loader.getPendingCount() > 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+		if (oak::hasResource<Res>("low")) {
+			printf("resource published before update\n");
+			return -1;
+		}
+		loader.update();
+	}
+	loader.finish();
+
+	if (decodeOrder != std::vector<int>{ 5, 1, 3 }) {
+		printf("wrong decode order:");
+		for (auto i : decodeOrder) { printf(" %i", i); }
+		printf("\n");
+		return -1;
+	}
+
+	if (blocker->value != 0.0f || low->value != 1.0f || high->value != 5.0f || created->value != 3.0f || created->list[0] != 3) {
+		printf("loaded resources have the wrong values\n");
+		return -1;
+	}
+
+	if (cancelled->value != -1.0f || oak::hasResource<Res>("cancelled")) {
+		printf("cancelled resource was published\n");
+		return -1;
+	}
+
+	//a load that is still queued when the loader is destroyed is dropped
+	{
+		oak::ResourceLoader::inst().load<Res>("late", 0, []() { return Res{ {}, 7.0f }; });
+	}
+
+	printf("done\n");
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <scene_events.h>
+#include <oakengine.h>
+#include <file_manager.h>
+#include <util/hash_puper.h>
+#include <container.h>
+
+struct TransformComponent {
+	static const oak::TypeInfo typeInfo;
+	oak::Vec2 position;
+	float rotation;
+	float scale;
+};
+
+const oak::TypeInfo TransformComponent::typeInfo = oak::makeComponentInfo<TransformComponent>("transform");
+
+struct NameComponent {
+	static const oak::TypeInfo typeInfo;
+	oak::string name;
+	uint32_t layer;
+};
+
+const oak::TypeInfo NameComponent::typeInfo = oak::makeComponentInfo<NameComponent>("name");
+
+void pup(oak::Puper& puper, TransformComponent& data, const oak::ObjInfo& info) {
+	pup(puper, data.position, oak::ObjInfo::make<oak::Vec2>(&info, "position"));
+	pup(puper, data.rotation, oak::ObjInfo::make<float>(&info, "rotation"));
+	pup(puper, data.scale, oak::ObjInfo::make<float>(&info, "scale"));
+}
+
+void pup(oak::Puper& puper, NameComponent& data, const oak::ObjInfo& info) {
+	pup(puper, data.name, oak::ObjInfo::make<oak::string>(&info, "name"));
+	pup(puper, data.layer, oak::ObjInfo::make<uint32_t>(&info, "layer"));
+}
+
+void populate(oak::Scene& scene, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		auto entity = scene.createEntity();
+		oak::addComponent<TransformComponent>(entity, scene, oak::Vec2{ static_cast<float>(i), 2.0f }, 0.5f, 1.0f);
+		if (i % 3 == 0) {
+			oak::addComponent<NameComponent>(entity, scene, oak::string{ "entity" } + std::to_string(i).c_str(), static_cast<uint32_t>(i % 7));
+		}
+		//leave some entities inactive
+		if (i % 5 != 0) {
+			scene.activateEntity(entity);
+		}
+	}
+}
+
+bool check(oak::Scene& scene, size_t count) {
+	const auto& entities = scene.getEntities();
+	if (entities.size() != count) {
+		printf("entity count: %lu, expected: %lu\n", entities.size(), count);
+		return false;
+	}
+	for (size_t i = 0; i < count; i++) {
+		auto entity = entities[i];
+		if (scene.isEntityActive(entity) != (i % 5 != 0)) {
+			printf("entity %lu has the wrong active state\n", i);
+			return false;
+		}
+		auto& tc = oak::getComponent<TransformComponent>(entity, scene);
+		if (tc.position.x != static_cast<float>(i) || tc.position.y != 2.0f || tc.rotation != 0.5f || tc.scale != 1.0f) {
+			printf("entity %lu has the wrong transform\n", i);
+			return false;
+		}
+		if (scene.hasComponent(entity, NameComponent::typeInfo.id) != (i % 3 == 0)) {
+			printf("entity %lu has the wrong components\n", i);
+			return false;
+		}
+		if (i % 3 == 0) {
+			auto& nc = oak::getComponent<NameComponent>(entity, scene);
+			if (nc.name != oak::string{ "entity" } + std::to_string(i).c_str() || nc.layer != i % 7) {
+				printf("entity %lu has the wrong name: %s\n", i, nc.name.c_str());
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int main(int argc, char **argv) {
+
+	oak::EventManager evtManager;
+	oak::addEventQueue<oak::EntityCreateEvent>();
+	oak::addEventQueue<oak::EntityDestroyEvent>();
+	oak::addEventQueue<oak::EntityActivateEvent>();
+	oak::addEventQueue<oak::EntityDeactivateEvent>();
+
+	oak::ComponentTypeManager ctm;
+	ctm.addType<TransformComponent>();
+	ctm.addType<NameComponent>();
+
+	oak::FileManager fm;
+	fm.mount("{$cwd}", "/");
+
+	//plain data components are stored as their bytes, components that own memory are puped
+	if (!oak::makeTypeSchema(TransformComponent::typeInfo).raw || oak::makeTypeSchema(NameComponent::typeInfo).raw) {
+		printf("incorrect component encodings\n");
+		return -1;
+	}
+
+	//round trip through both scene formats
+	for (auto format : { "binary", "stream" }) {
+		const bool binary = format[0] == 'b';
+		const oak::string path = binary ? "/scene_io.oaks" : "/scene_io.scene";
+		{
+			oak::Scene scene;
+			scene.init();
+			populate(scene, 1000);
+			binary ? scene.save(path) : scene.saveStream(path);
+			scene.reset();
+			evtManager.clear();
+			scene.terminate();
+		}
+		{
+			oak::Scene scene;
+			scene.init();
+			//load detects the format from the header
+			scene.load(path);
+			if (!check(scene, 1000)) {
+				printf("%s scene did not round trip\n", format);
+				return -1;
+			}
+			scene.reset();
+			evtManager.clear();
+			scene.terminate();
+		}
+	}
+
+	//damaged binary files are rejected or loaded partially with warnings instead of crashing
+	{
+		oak::Scene scene;
+		scene.init();
+		populate(scene, 100);
+		scene.save("/scene_io.oaks");
+
+		FILE *file = fopen("scene_io.oaks", "rb");
+		std::vector<char> bytes(1 << 16);
+		bytes.resize(fread(bytes.data(), 1, bytes.size(), file));
+		fclose(file);
+
+		auto write = [](const std::vector<char>& data, size_t size) {
+			FILE *file = fopen("scene_io_bad.oaks", "wb");
+			fwrite(data.data(), 1, size, file);
+			fclose(file);
+		};
+
+		//a file from another engine version is not loaded and the scene is left alone
+		auto version = bytes;
+		version[4] = 99;
+		write(version, version.size());
+		scene.load("/scene_io_bad.oaks");
+		if (!check(scene, 100)) {
+			printf("scene changed by a file with the wrong version\n");
+			return -1;
+		}
+
+		for (size_t size = 24; size < bytes.size(); size += 37) {
+			write(bytes, size);
+			scene.load("/scene_io_bad.oaks");
+			if (scene.getEntities().size() != 100) {
+				printf("truncated file created %lu entities\n", scene.getEntities().size());
+				return -1;
+			}
+		}
+		evtManager.clear();
+		scene.reset();
+		evtManager.clear();
+		scene.terminate();
+		remove("scene_io_bad.oaks");
+	}
+
+	//save and load throughput of both formats
+	constexpr size_t BENCH_COUNT = 100000;
+	for (auto format : { "binary", "stream" }) {
+		const bool binary = format[0] == 'b';
+		const oak::string path = binary ? "/scene_io.oaks" : "/scene_io.scene";
+		oak::Scene scene;
+		scene.init();
+		populate(scene, BENCH_COUNT);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		binary ? scene.save(path) : scene.saveStream(path);
+		auto mid = std::chrono::high_resolution_clock::now();
+		scene.load(path);
+		auto end = std::chrono::high_resolution_clock::now();
+		evtManager.clear();
+
+		printf("%s save: %lins/entity, load: %lins/entity\n", format,
+			std::chrono::nanoseconds{ mid - start }.count() / BENCH_COUNT, std::chrono::nanoseconds{ end - mid }.count() / BENCH_COUNT);
+		if (!check(scene, BENCH_COUNT)) {
+			printf("%s scene did not round trip\n", format);
+			return -1;
+		}
+		scene.reset();
+		evtManager.clear();
+		scene.terminate();
+	}
+
+	remove("scene_io.oaks");
+	remove("scene_io.scene");
+
+	printf("done\n");
+
+	return 0;
+}
\ No newline at end of file
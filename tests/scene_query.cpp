@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <scene_events.h>
+#include <oakengine.h>
+#include <entity_cache.h>
+
+struct TransformComponent {
+	static const oak::TypeInfo typeInfo;
+	oak::Vec2 position;
+};
+
+const oak::TypeInfo TransformComponent::typeInfo = oak::makeComponentInfo<TransformComponent>("transform");
+
+void pup(oak::Puper& puper, TransformComponent& data, const oak::ObjInfo& info) {}
+
+int main(int argc, char **argv) {
+
+	oak::EventManager evtManager;
+
+	oak::addEventQueue<oak::EntityCreateEvent>();
+	oak::addEventQueue<oak::EntityDestroyEvent>();
+	oak::addEventQueue<oak::EntityActivateEvent>();
+	oak::addEventQueue<oak::EntityDeactivateEvent>();
+
+	oak::ComponentTypeManager ctm;
+	ctm.addType<TransformComponent>();
+
+	oak::Scene scene;
+	scene.init();
+
+	const auto& query = scene.getQuery<TransformComponent>();
+
+	//a frame: the systems activate entities, the scene is updated, then the events are cleared
+	auto entity = scene.createEntity();
+	oak::addComponent<TransformComponent>(entity, scene, oak::Vec2{ 0.0f });
+	scene.activateEntity(entity);
+
+	//queries only change in update so systems running in the same frame see the same entities
+	if (query.contains(entity)) {
+		printf("query changed before the scene was updated\n");
+		return -1;
+	}
+	scene.update();
+	if (!query.contains(entity)) {
+		printf("activated entity is not in the query\n");
+		return -1;
+	}
+	//updating the queries does not consume the events, anything after the update still sees them
+	if (oak::getEventQueue<oak::EntityActivateEvent>().size() != 1) {
+		printf("activate event was consumed by the update\n");
+		return -1;
+	}
+	evtManager.clear();
+
+	//the next frame deactivates the entity, it stays in the query until the scene is updated
+	scene.deactivateEntity(entity);
+	if (!query.contains(entity)) {
+		printf("query changed before the scene was updated\n");
+		return -1;
+	}
+	scene.update();
+	evtManager.clear();
+	if (query.contains(entity) || !query.entities().empty()) {
+		printf("deactivated entity is still in the query\n");
+		return -1;
+	}
+
+	//events cleared before the update are lost to the queries
+	scene.activateEntity(entity);
+	evtManager.clear();
+	scene.update();
+	if (query.contains(entity)) {
+		printf("query saw a cleared event\n");
+		return -1;
+	}
+
+	scene.reset();
+	evtManager.clear();
+	scene.terminate();
+
+	printf("done\n");
+
+	return 0;
+}
\ No newline at end of file